@@ -12,7 +12,7 @@ public class GPUtils : ModuleRules
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "OnlineSubsystem", });
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "CoreUObject", "Engine", "RenderCore", });
+		PrivateDependencyModuleNames.AddRange(new string[] { "CoreUObject", "Engine", "RenderCore", "Sockets", });
 		PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 
 		DynamicallyLoadedModuleNames.AddRange(new string[] {  });
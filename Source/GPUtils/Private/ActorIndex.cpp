@@ -0,0 +1,237 @@
+#include <GPUtils/ActorIndex.h>
+
+#include <Engine/Level.h>
+#include <Engine/World.h>
+#include <EngineUtils.h>
+#include <GameFramework/Actor.h>
+#include <UObject/UObjectGlobals.h>
+
+void UActorIndexSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	const auto world = GetWorld();
+	actorSpawned = world->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UActorIndexSubsystem::OnActorSpawned));
+	levelAdded = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UActorIndexSubsystem::OnLevelAdded);
+	postActorTick = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UActorIndexSubsystem::Compact);
+	postGarbageCollect = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UActorIndexSubsystem::OnPostGarbageCollect);
+}
+
+void UActorIndexSubsystem::Deinitialize()
+{
+	if (const auto world = GetWorld())
+		world->RemoveOnActorSpawnedHandler(actorSpawned);
+	FWorldDelegates::LevelAddedToWorld.Remove(levelAdded);
+	FWorldDelegates::OnWorldPostActorTick.Remove(postActorTick);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(postGarbageCollect);
+	buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+void UActorIndexSubsystem::EnableIndex(UClass* actorClass)
+{
+	check(actorClass && actorClass->IsChildOf<AActor>());
+	if (buckets.Contains(actorClass))
+		return;
+
+	auto& bucket = buckets.Add(actorClass);
+	bucket.flags.SetNum(flagDefinitions.Num());
+	for (auto it = TActorIterator<AActor>{ GetWorld(), actorClass }; it; ++it)
+		Add(*it, bucket);
+}
+
+uint64 UActorIndexSubsystem::DefineFlag(FName name, TFunction<bool(const AActor*)> predicate, bool perFrame)
+{
+	return DefineFlag(EActorFlagKind::Custom, name, MoveTemp(predicate), perFrame);
+}
+
+uint64 UActorIndexSubsystem::DefineFlag(EActorFlagKind kind, FName name, TFunction<bool(const AActor*)> predicate, bool perFrame)
+{
+	if (const auto existing = GetFlag(kind, name))
+		return existing;
+
+	checkf(flagDefinitions.Num() < 64, TEXT("Too many actor flags."));
+	const auto flag = flagDefinitions.Num();
+	flagDefinitions.Add({ kind, name, MoveTemp(predicate), perFrame, });
+
+	for (auto& pair : buckets)
+	{
+		auto& bucket = pair.Value;
+		auto& bits = bucket.flags.AddDefaulted_GetRef();
+		for (const auto actor : bucket.actors)
+			bits.Add(actor && flagDefinitions[flag].predicate(actor));
+	}
+
+	return uint64(1) << flag;
+}
+
+uint64 UActorIndexSubsystem::DefineTagFlag(FName tag)
+{
+	return DefineFlag(EActorFlagKind::Tag, tag, [tag](const AActor* actor) { return actor->ActorHasTag(tag); }, false);
+}
+
+uint64 UActorIndexSubsystem::DefineInterfaceFlag(UClass* interfaceClass)
+{
+	check(interfaceClass && interfaceClass->HasAnyClassFlags(CLASS_Interface));
+	// The path, interfaces of different modules may share a name.
+	return DefineFlag(EActorFlagKind::Interface, FName(*interfaceClass->GetPathName()), [interfaceClass](const AActor* actor) { return actor->GetClass()->ImplementsInterface(interfaceClass); }, false);
+}
+
+uint64 UActorIndexSubsystem::DefineHiddenFlag()
+{
+	return DefineFlag(EActorFlagKind::Builtin, TEXT("Hidden"), [](const AActor* actor) { return actor->IsHidden(); }, true);
+}
+
+uint64 UActorIndexSubsystem::GetFlag(EActorFlagKind kind, FName name) const
+{
+	const auto flag = flagDefinitions.IndexOfByPredicate([&](const FActorFlag& definition) { return definition.kind == kind && definition.name == name; });
+	return flag == INDEX_NONE ? 0 : uint64(1) << flag;
+}
+
+void UActorIndexSubsystem::RefreshFlags(AActor* actor)
+{
+	for (auto& pair : buckets)
+		if (const auto slot = pair.Value.slots.Find(actor))
+			EvaluateFlags(pair.Value, *slot, false);
+}
+
+bool UActorIndexSubsystem::Matches(const AActor* actor, uint64 required, uint64 excluded) const
+{
+	for (auto flag = 0; flag < flagDefinitions.Num(); ++flag)
+	{
+		const auto mask = uint64(1) << flag;
+		if ((required | excluded) & mask && flagDefinitions[flag].predicate(actor) != ((required & mask) != 0))
+			return false;
+	}
+	return true;
+}
+
+const FActorIndexBucket* UActorIndexSubsystem::Find(UClass* actorClass) const
+{
+	return buckets.Find(actorClass);
+}
+
+void UActorIndexSubsystem::Add(AActor* actor, FActorIndexBucket& bucket)
+{
+	if (!IsValid(actor) || bucket.slots.Contains(actor))
+		return;
+
+	const auto slot = bucket.actors.Add(actor);
+	bucket.slots.Add(actor, slot);
+	bucket.present.Add(true);
+	for (auto& bits : bucket.flags)
+		bits.Add(false);
+	EvaluateFlags(bucket, slot, false);
+
+	actor->OnEndPlay.AddUniqueDynamic(this, &UActorIndexSubsystem::OnActorEndPlay);
+}
+
+void UActorIndexSubsystem::EvaluateFlags(FActorIndexBucket& bucket, int32 slot, bool perFrameOnly) const
+{
+	const auto actor = bucket.actors[slot];
+	for (auto flag = 0; flag < flagDefinitions.Num(); ++flag)
+		if (!perFrameOnly || flagDefinitions[flag].perFrame)
+			bucket.flags[flag][slot] = actor && flagDefinitions[flag].predicate(actor);
+}
+
+void UActorIndexSubsystem::OnActorSpawned(AActor* actor)
+{
+	for (auto& pair : buckets)
+		if (actor->IsA(pair.Key))
+			Add(actor, pair.Value);
+}
+
+void UActorIndexSubsystem::OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason)
+{
+	for (auto& pair : buckets)
+	{
+		auto& bucket = pair.Value;
+		int32 slot;
+		if (bucket.slots.RemoveAndCopyValue(actor, slot))
+		{
+			bucket.actors[slot] = nullptr;
+			bucket.present[slot] = false;
+			++bucket.removed;
+		}
+	}
+}
+
+void UActorIndexSubsystem::OnPostGarbageCollect()
+{
+	// Actors collected without ending play were nulled by the collector, but still count as present. They're removed like ended ones, in place so
+	// that ranges being iterated stay valid. Their slots keys dangle and could match new actors allocated at the same address, so the map is rebuilt.
+	for (auto& pair : buckets)
+	{
+		auto& bucket = pair.Value;
+		auto swept = false;
+		for (auto i = 0; i < bucket.actors.Num(); ++i)
+		{
+			if (bucket.actors[i] != nullptr || !bucket.present[i])
+				continue;
+
+			bucket.present[i] = false;
+			++bucket.removed;
+			swept = true;
+		}
+
+		if (!swept)
+			continue;
+
+		bucket.slots.Reset();
+		for (auto i = 0; i < bucket.actors.Num(); ++i)
+			if (bucket.actors[i] != nullptr)
+				bucket.slots.Add(bucket.actors[i], i);
+	}
+}
+
+void UActorIndexSubsystem::OnLevelAdded(ULevel* level, UWorld* world)
+{
+	if (world != GetWorld() || level == nullptr)
+		return;
+
+	for (const auto actor : level->Actors)
+		if (actor)
+			OnActorSpawned(actor);
+}
+
+void UActorIndexSubsystem::Compact(UWorld* world, ELevelTick tickType, float deltaSeconds)
+{
+	if (world != GetWorld())
+		return;
+
+	const auto perFrame = flagDefinitions.ContainsByPredicate([](const FActorFlag& definition) { return definition.perFrame; });
+
+	for (auto& pair : buckets)
+	{
+		auto& bucket = pair.Value;
+		if (bucket.removed > 0)
+		{
+			auto kept = 0;
+			bucket.slots.Reset();
+			for (auto i = 0; i < bucket.actors.Num(); ++i)
+			{
+				const auto actor = bucket.actors[i];
+				if (actor == nullptr)
+					continue;
+
+				bucket.actors[kept] = actor;
+				bucket.slots.Add(actor, kept);
+				for (auto& bits : bucket.flags)
+					bits[kept] = static_cast<bool>(bits[i]);
+				++kept;
+			}
+
+			const auto dropped = bucket.actors.Num() - kept;
+			bucket.actors.SetNum(kept);
+			bucket.present.Init(true, kept);
+			for (auto& bits : bucket.flags)
+				bits.RemoveAt(kept, dropped);
+			bucket.removed = 0;
+		}
+
+		if (perFrame)
+			for (auto i = 0; i < bucket.actors.Num(); ++i)
+				EvaluateFlags(bucket, i, true);
+	}
+}
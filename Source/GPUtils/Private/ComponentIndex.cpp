@@ -0,0 +1,207 @@
+#include <GPUtils/ComponentIndex.h>
+
+#include <Components/ActorComponent.h>
+#include <Engine/Level.h>
+#include <Engine/World.h>
+#include <EngineUtils.h>
+#include <GameFramework/Actor.h>
+#include <UObject/UObjectGlobals.h>
+
+void UComponentIndexSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	const auto world = GetWorld();
+	actorSpawned = world->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UComponentIndexSubsystem::OnActorSpawned));
+	levelAdded = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UComponentIndexSubsystem::OnLevelAdded);
+	postActorTick = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UComponentIndexSubsystem::Compact);
+	postGarbageCollect = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UComponentIndexSubsystem::OnPostGarbageCollect);
+}
+
+void UComponentIndexSubsystem::Deinitialize()
+{
+	if (const auto world = GetWorld())
+		world->RemoveOnActorSpawnedHandler(actorSpawned);
+	FWorldDelegates::LevelAddedToWorld.Remove(levelAdded);
+	FWorldDelegates::OnWorldPostActorTick.Remove(postActorTick);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(postGarbageCollect);
+	buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+void UComponentIndexSubsystem::EnableIndex(UClass* componentClass)
+{
+	check(componentClass && componentClass->IsChildOf<UActorComponent>());
+	if (buckets.Contains(componentClass))
+		return;
+
+	auto& bucket = buckets.Add(componentClass);
+	for (auto it = TActorIterator<AActor>{ GetWorld() }; it; ++it)
+		AddActor(*it, componentClass, bucket);
+}
+
+void UComponentIndexSubsystem::EnableTagFilter(UClass* componentClass, FName tag)
+{
+	EnableIndex(componentClass);
+	auto& bucket = buckets[componentClass];
+	if (bucket.tags.Contains(tag))
+		return;
+
+	auto& bits = bucket.tags.Add(tag);
+	for (const auto component : bucket.components)
+		bits.Add(component && component->ComponentHasTag(tag));
+}
+
+void UComponentIndexSubsystem::EnableInterfaceFilter(UClass* componentClass, UClass* interfaceClass)
+{
+	check(interfaceClass && interfaceClass->HasAnyClassFlags(CLASS_Interface));
+	EnableIndex(componentClass);
+	auto& bucket = buckets[componentClass];
+	if (bucket.interfaces.Contains(interfaceClass))
+		return;
+
+	auto& bits = bucket.interfaces.Add(interfaceClass);
+	for (const auto component : bucket.components)
+		bits.Add(component && component->GetClass()->ImplementsInterface(interfaceClass));
+}
+
+void UComponentIndexSubsystem::NotifyRegistered(UActorComponent* component)
+{
+	auto added = false;
+	for (auto& pair : buckets)
+	{
+		if (!component->IsA(pair.Key))
+			continue;
+
+		// Re-adding refreshes the filter bits, e.g. after the tags changed.
+		Remove(component, pair.Value);
+		Add(component, pair.Value);
+		added = true;
+	}
+
+	const auto owner = component->GetOwner();
+	if (added && owner)
+		owner->OnEndPlay.AddUniqueDynamic(this, &UComponentIndexSubsystem::OnActorEndPlay);
+}
+
+void UComponentIndexSubsystem::NotifyUnregistered(UActorComponent* component)
+{
+	for (auto& pair : buckets)
+		Remove(component, pair.Value);
+}
+
+const FComponentIndexBucket* UComponentIndexSubsystem::Find(UClass* componentClass) const
+{
+	return buckets.Find(componentClass);
+}
+
+void UComponentIndexSubsystem::Add(UActorComponent* component, FComponentIndexBucket& bucket)
+{
+	if (!IsValid(component) || bucket.slots.Contains(component))
+		return;
+
+	bucket.slots.Add(component, bucket.components.Add(component));
+	for (auto& pair : bucket.tags)
+		pair.Value.Add(component->ComponentHasTag(pair.Key));
+	for (auto& pair : bucket.interfaces)
+		pair.Value.Add(component->GetClass()->ImplementsInterface(pair.Key));
+}
+
+void UComponentIndexSubsystem::Remove(UActorComponent* component, FComponentIndexBucket& bucket)
+{
+	int32 slot;
+	if (!bucket.slots.RemoveAndCopyValue(component, slot))
+		return;
+
+	bucket.components[slot] = nullptr;
+	for (auto& pair : bucket.tags)
+		pair.Value[slot] = false;
+	for (auto& pair : bucket.interfaces)
+		pair.Value[slot] = false;
+	++bucket.removed;
+}
+
+void UComponentIndexSubsystem::AddActor(AActor* actor, UClass* componentClass, FComponentIndexBucket& bucket)
+{
+	if (!IsValid(actor))
+		return;
+
+	auto added = false;
+	actor->ForEachComponent(false, [&](UActorComponent* component)
+		{
+			if (component->IsRegistered() && component->IsA(componentClass))
+			{
+				Add(component, bucket);
+				added = true;
+			}
+		});
+
+	if (added)
+		actor->OnEndPlay.AddUniqueDynamic(this, &UComponentIndexSubsystem::OnActorEndPlay);
+}
+
+void UComponentIndexSubsystem::OnActorSpawned(AActor* actor)
+{
+	for (auto& pair : buckets)
+		AddActor(actor, pair.Key, pair.Value);
+}
+
+void UComponentIndexSubsystem::OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason)
+{
+	for (auto& pair : buckets)
+		actor->ForEachComponent(false, [&](UActorComponent* component) { Remove(component, pair.Value); });
+}
+
+void UComponentIndexSubsystem::OnLevelAdded(ULevel* level, UWorld* world)
+{
+	if (world != GetWorld() || level == nullptr)
+		return;
+
+	for (const auto actor : level->Actors)
+		if (actor)
+			OnActorSpawned(actor);
+}
+
+void UComponentIndexSubsystem::Compact(UWorld* world, ELevelTick tickType, float deltaSeconds)
+{
+	if (world != GetWorld())
+		return;
+
+	// Components destroyed without being unregistered (DestroyComponent without NotifyUnregistered) never count as removed. The garbage collector
+	// nulls them in components but not in slots, whose keys then dangle, so every bucket is scanned and its slots rebuilt after a collection.
+	const auto scanAll = collected;
+	collected = false;
+
+	for (auto& pair : buckets)
+	{
+		auto& bucket = pair.Value;
+		if (bucket.removed == 0 && !scanAll)
+			continue;
+
+		auto kept = 0;
+		bucket.slots.Reset();
+		for (auto i = 0; i < bucket.components.Num(); ++i)
+		{
+			const auto component = bucket.components[i];
+			if (!IsValid(component))
+				continue;
+
+			bucket.components[kept] = component;
+			bucket.slots.Add(component, kept);
+			for (auto& filter : bucket.tags)
+				filter.Value[kept] = static_cast<bool>(filter.Value[i]);
+			for (auto& filter : bucket.interfaces)
+				filter.Value[kept] = static_cast<bool>(filter.Value[i]);
+			++kept;
+		}
+
+		const auto dropped = bucket.components.Num() - kept;
+		bucket.components.SetNum(kept);
+		for (auto& filter : bucket.tags)
+			filter.Value.RemoveAt(kept, dropped);
+		for (auto& filter : bucket.interfaces)
+			filter.Value.RemoveAt(kept, dropped);
+		bucket.removed = 0;
+	}
+}
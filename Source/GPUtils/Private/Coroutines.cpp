@@ -0,0 +1,47 @@
+#include <GPUtils/Coroutines.h>
+
+#include <Containers/LockFreeFixedSizeAllocator.h>
+
+namespace
+{
+	// Frames are served from power of two size classes, larger ones from the general allocator. Freed blocks go back to a lock-free list of their class.
+	template <int32 Size>
+	using TFramePool = TLockFreeFixedSizeAllocator<Size, PLATFORM_CACHE_LINE_SIZE>;
+
+	TFramePool<128> frames128;
+	TFramePool<256> frames256;
+	TFramePool<512> frames512;
+	TFramePool<1024> frames1024;
+	TFramePool<2048> frames2048;
+}
+
+void* Coro::AllocateFrame(SIZE_T size)
+{
+	if (size <= 128)
+		return frames128.Allocate();
+	if (size <= 256)
+		return frames256.Allocate();
+	if (size <= 512)
+		return frames512.Allocate();
+	if (size <= 1024)
+		return frames1024.Allocate();
+	if (size <= 2048)
+		return frames2048.Allocate();
+	return FMemory::Malloc(size);
+}
+
+void Coro::FreeFrame(void* frame, SIZE_T size)
+{
+	if (size <= 128)
+		frames128.Free(frame);
+	else if (size <= 256)
+		frames256.Free(frame);
+	else if (size <= 512)
+		frames512.Free(frame);
+	else if (size <= 1024)
+		frames1024.Free(frame);
+	else if (size <= 2048)
+		frames2048.Free(frame);
+	else
+		FMemory::Free(frame);
+}
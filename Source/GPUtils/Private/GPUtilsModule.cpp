@@ -2,19 +2,45 @@
 
 #include "GPUtilsModule.h"
 
+#include <GPUtils/Jobs.h>
+#include <GPUtils/Sessions.h>
+#include <GPUtils/Threads.h>
+
+#include <Containers/Ticker.h>
+#include <Engine/World.h>
+
 #define LOCTEXT_NAMESPACE "FGPUtilsModule"
 
 void FGPUtilsModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// ExecuteInGameThread delegates are drained at whichever of these points GPUtils.GameThreadQueue.DrainPoint selects.
+	engineTick = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+		{
+			DrainGameThreadQueue(EGameThreadDrainPoint::EngineTick);
+			RunGameThreadBudget();
+			return true;
+		}));
+	worldTickStart = FWorldDelegates::OnWorldTickStart.AddLambda([](UWorld*, ELevelTick, float) { DrainGameThreadQueue(EGameThreadDrainPoint::WorldTickStart); });
+	postActorTick = FWorldDelegates::OnWorldPostActorTick.AddLambda([](UWorld*, ELevelTick, float) { DrainGameThreadQueue(EGameThreadDrainPoint::PostActorTick); });
 }
 
 void FGPUtilsModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FTicker::GetCoreTicker().RemoveTicker(engineTick);
+	FWorldDelegates::OnWorldTickStart.Remove(worldTickStart);
+	FWorldDelegates::OnWorldPostActorTick.Remove(postActorTick);
+
+	ShutdownJobs();
+	ShutdownSessionSearches();
+
+	// Run what's left, the delegates may own resources that expect to be released on the game thread.
+	FlushGameThreadQueue();
 }
 
 #undef LOCTEXT_NAMESPACE
 
-IMPLEMENT_MODULE(FGPUtilsModule, GPUtils)
\ No newline at end of file
+IMPLEMENT_MODULE(FGPUtilsModule, GPUtils)
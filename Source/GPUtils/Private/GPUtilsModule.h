@@ -3,6 +3,7 @@
 #pragma once
 
 #include <CoreMinimal.h>
+#include <Containers/Ticker.h>
 #include <Modules/ModuleManager.h>
 
 class FGPUtilsModule : public IModuleInterface
@@ -12,4 +13,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	FDelegateHandle engineTick;
+	FDelegateHandle worldTickStart;
+	FDelegateHandle postActorTick;
 };
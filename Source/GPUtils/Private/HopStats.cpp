@@ -0,0 +1,205 @@
+#include <GPUtils/HopStats.h>
+
+#if GPUTILS_HOP_STATS
+
+#include <HAL/IConsoleManager.h>
+#include <Misc/ScopeLock.h>
+
+#include <atomic>
+
+namespace
+{
+	constexpr auto MaxTags = 32;
+
+	// Four buckets per power of two nanoseconds, up to about an hour: values are off by at most a quarter of their magnitude.
+	constexpr auto NumBuckets = 168;
+
+	enum EHistogram { Wait, Run, NumHistograms, };
+
+	int32 Bucket(uint64 ns)
+	{
+		if (ns < 4)
+			return static_cast<int32>(ns);
+		const auto exponent = static_cast<int32>(FMath::FloorLog2_64(ns));
+		return FMath::Min(exponent * 4 + static_cast<int32>((ns >> (exponent - 2)) & 3) - 4, NumBuckets - 1);
+	}
+
+	// Middle of the range of values that fall into the bucket.
+	double BucketMs(int32 bucket)
+	{
+		if (bucket < 4)
+			return bucket / 1e6;
+		const auto exponent = bucket / 4 + 1;
+		const auto lower = double(4 + bucket % 4) * double(uint64(1) << (exponent - 2));
+		return (lower + double(uint64(1) << (exponent - 2)) / 2) / 1e6;
+	}
+
+	// Histograms of one thread. Only that thread writes, so increments are a plain load and store. Readers may see a count a few hops behind.
+	struct FThreadHistograms
+	{
+		std::atomic<uint32> counts[MaxTags][NumHistograms][NumBuckets];
+		std::atomic<bool> used{ true };
+
+		FThreadHistograms()
+		{
+			for (auto& tag : counts)
+				for (auto& histogram : tag)
+					for (auto& count : histogram)
+						count.store(0, std::memory_order_relaxed);
+		}
+
+		void Add(int32 tag, EHistogram histogram, uint64 cycles)
+		{
+			auto& count = counts[tag][histogram][Bucket(static_cast<uint64>(cycles * FPlatformTime::GetSecondsPerCycle64() * 1e9))];
+			count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+	};
+
+	struct FRegistry
+	{
+		FCriticalSection lock;
+		TArray<TUniquePtr<FThreadHistograms>> threads;
+
+		// Copies, tags of a module outlive it in the stats.
+		int32 numTags = 0;
+		FString names[MaxTags];
+
+		// Merged counts at the last reset, subtracted when reading. Only touched under the lock.
+		uint64 baseline[MaxTags][NumHistograms][NumBuckets] = {};
+		double resetTime = FPlatformTime::Seconds();
+
+		static FRegistry& Get()
+		{
+			static FRegistry registry;
+			return registry;
+		}
+
+		// Index of the tag with this name, shared by every GPUTILS_HOP_TAG of it: a tag in a template or an inline function has a static per
+		// instantiation and per module. MaxTags once they're all taken.
+		int32 Register(const TCHAR* name)
+		{
+			FScopeLock scope(&lock);
+			for (auto tag = 0; tag < numTags; ++tag)
+				if (names[tag].Equals(name, ESearchCase::CaseSensitive))
+					return tag;
+
+			if (numTags == MaxTags)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Hop tag %s isn't recorded, there are more than %d."), name, MaxTags);
+				return MaxTags;
+			}
+
+			names[numTags] = name;
+			return numTags++;
+		}
+
+		// Histograms of exited threads are handed to new ones, keeping their counts.
+		FThreadHistograms* Acquire()
+		{
+			FScopeLock scope(&lock);
+			for (auto& thread : threads)
+			{
+				auto expected = false;
+				if (thread->used.compare_exchange_strong(expected, true))
+					return thread.Get();
+			}
+			return threads.Add_GetRef(MakeUnique<FThreadHistograms>()).Get();
+		}
+	};
+
+	struct FThreadSlot
+	{
+		FThreadHistograms* histograms = FRegistry::Get().Acquire();
+
+		~FThreadSlot() { histograms->used = false; }
+	};
+
+	thread_local FThreadSlot slot;
+}
+
+FHopTag::FHopTag(const TCHAR* name_)
+	: name(name_)
+	, index(FRegistry::Get().Register(name_))
+{
+}
+
+FHopScope::FHopScope(const FHopTag& tag_, uint64 enqueued)
+	: tag(tag_)
+	, start(FPlatformTime::Cycles64())
+{
+	if (tag.index < MaxTags)
+		slot.histograms->Add(tag.index, Wait, start - enqueued);
+}
+
+FHopScope::~FHopScope()
+{
+	if (tag.index < MaxTags)
+		slot.histograms->Add(tag.index, Run, FPlatformTime::Cycles64() - start);
+}
+
+TArray<FHopStats> GetHopStats(bool reset)
+{
+	auto& registry = FRegistry::Get();
+	FScopeLock scope(&registry.lock);
+
+	const auto now = FPlatformTime::Seconds();
+	const auto seconds = FMath::Max(now - registry.resetTime, 1e-6);
+	const auto numTags = registry.numTags;
+
+	auto ret = TArray<FHopStats>{};
+	for (auto tag = 0; tag < numTags; ++tag)
+	{
+		uint64 merged[NumHistograms][NumBuckets] = {};
+		for (const auto& thread : registry.threads)
+			for (auto histogram = 0; histogram < NumHistograms; ++histogram)
+				for (auto bucket = 0; bucket < NumBuckets; ++bucket)
+					merged[histogram][bucket] += thread->counts[tag][histogram][bucket].load(std::memory_order_relaxed);
+
+		auto count = uint64(0);
+		for (auto bucket = 0; bucket < NumBuckets; ++bucket)
+			count += merged[Wait][bucket] - registry.baseline[tag][Wait][bucket];
+
+		auto stats = FHopStats{};
+		stats.tag = registry.names[tag];
+		stats.count = count;
+		stats.perSecond = count / seconds;
+
+		for (auto histogram = 0; histogram < NumHistograms; ++histogram)
+		{
+			auto& percentiles = histogram == Wait ? stats.waitMs : stats.runMs;
+			const double ranks[] = { 0.5, 0.95, 0.99, };
+			auto seen = uint64(0);
+			auto next = 0;
+			for (auto bucket = 0; bucket < NumBuckets && next < 3; ++bucket)
+			{
+				seen += merged[histogram][bucket] - registry.baseline[tag][histogram][bucket];
+				while (next < 3 && count > 0 && seen >= FMath::Max<uint64>(static_cast<uint64>(ranks[next] * count), 1))
+					percentiles[next++] = BucketMs(bucket);
+			}
+
+			if (reset)
+				FMemory::Memcpy(registry.baseline[tag][histogram], merged[histogram], sizeof(merged[histogram]));
+		}
+
+		if (count > 0)
+			ret.Add(MoveTemp(stats));
+	}
+
+	if (reset)
+		registry.resetTime = now;
+	return ret;
+}
+
+static FAutoConsoleCommand HopStatsCommand(
+	TEXT("GPUtils.HopStats"),
+	TEXT("Logs the wait and run time percentiles of GPUtils thread hops per call site. Pass reset to start over afterwards."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args)
+		{
+			const auto stats = GetHopStats(args.Num() > 0 && args[0] == TEXT("reset"));
+			UE_LOG(LogTemp, Display, TEXT("%-32s %10s %10s %28s %28s"), TEXT("Tag"), TEXT("Count"), TEXT("Per second"), TEXT("Wait p50/p95/p99 ms"), TEXT("Run p50/p95/p99 ms"));
+			for (const auto& tag : stats)
+				UE_LOG(LogTemp, Display, TEXT("%-32s %10llu %10.1f %8.3f/%8.3f/%8.3f %8.3f/%8.3f/%8.3f"), *tag.tag, tag.count, tag.perSecond,
+					tag.waitMs[0], tag.waitMs[1], tag.waitMs[2], tag.runMs[0], tag.runMs[1], tag.runMs[2]);
+		}));
+
+#endif
@@ -1,6 +1,10 @@
 #include <GPUtils/ImageLoader.h>
 
-#include <Async/Async.h>
+#include <GPUtils/Coroutines.h>
+#include <GPUtils/HopStats.h>
+#include <GPUtils/Jobs.h>
+
+#include <Async/Future.h>
 #include <Engine/Texture2D.h>
 #include <IImageWrapper.h>
 #include <IImageWrapperModule.h>
@@ -14,6 +18,16 @@
 // Module loading is not allowed outside of the main thread, so we load the ImageWrapper module ahead of time.
 static IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
 
+// Runs the load on the job workers. The promise calls CompletionCallback once the value is set, like Async does.
+template <class TLoad>
+static TFuture<UTexture2D*> LaunchImageJob(TLoad&& Load, TFunction<void()>&& CompletionCallback)
+{
+	auto Promise = MakeShared<TPromise<UTexture2D*>, ESPMode::ThreadSafe>(MoveTemp(CompletionCallback));
+	auto Future = Promise->GetFuture();
+	LaunchJob([Promise, Load = Forward<TLoad>(Load)]() mutable { Promise->SetValue(Load()); });
+	return Future;
+}
+
 UImageLoader* UImageLoader::LoadImageFromDiskAsyncBP(UObject* Outer, const FString& ImagePath)
 {
 	// This simply creates a new ImageLoader object and starts an asynchronous load.
@@ -24,30 +38,27 @@ UImageLoader* UImageLoader::LoadImageFromDiskAsyncBP(UObject* Outer, const FStri
 
 void UImageLoader::LoadImageAsync(UObject* Outer, const FString& ImagePath)
 {
-	// The asynchronous loading operation is represented by a Future, which will contain the result value once the operation is done.
-	// We store the Future in this object, so we can retrieve the result value in the completion callback below.
-	Future = LoadImageFromDiskAsync(Outer, ImagePath, [this]()
-		{
-			// This is the same Future object that we assigned above, but later in time.
-			// At this point, loading is done and the Future contains a value.
-			if (Future.IsValid())
-			{
-				// Notify listeners about the loaded texture on the game thread.
-				AsyncTask(ENamedThreads::GameThread, [this]() { LoadCompleted.Broadcast(Future.Get()); });
-			}
-		});
+	// The coroutine suspends until the worker thread is done loading, then notifies listeners about the loaded texture on the game thread.
+	// Its parameters are copied into the coroutine frame, so it doesn't capture anything that could go out of scope while it waits.
+	[](TWeakObjectPtr<UImageLoader> Loader, TFuture<UTexture2D*> Loading) -> Coro::Task<>
+	{
+		UTexture2D* Texture = co_await MoveTemp(Loading);
+		co_await Coro::ToGameThread();
+		if (Loader.IsValid())
+			Loader->LoadCompleted.Broadcast(Texture);
+	}(this, LoadImageFromDiskAsync(Outer, ImagePath)).Start();
 }
 
 TFuture<UTexture2D*> UImageLoader::LoadImageFromDiskAsync(UObject* Outer, const FString& ImagePath, TFunction<void()> CompletionCallback)
 {
 	// Run the image loading function asynchronously through a lambda expression, capturing the ImagePath string by value.
-	// Run it on the thread pool, so we can load multiple images simultaneously without interrupting other tasks.
-	return Async(EAsyncExecution::ThreadPool, [=]() { return LoadImageFromDisk(Outer, ImagePath); }, CompletionCallback);
+	// Run it as a job, so we can load multiple images simultaneously without interrupting other tasks.
+	return LaunchImageJob(InstrumentHop(GPUTILS_HOP_TAG("ImageLoader.LoadFromDisk"), [=]() { return LoadImageFromDisk(Outer, ImagePath); }), MoveTemp(CompletionCallback));
 }
 
 TFuture<UTexture2D*> UImageLoader::LoadImageFromBlobAsync(UObject* Outer, const FString& name, const TArray<uint8>& data, TFunction<void()> CompletionCallback)
 {
-	return Async(EAsyncExecution::ThreadPool, [=]() { return LoadImageFromBlob(Outer, name, data); }, CompletionCallback);
+	return LaunchImageJob(InstrumentHop(GPUTILS_HOP_TAG("ImageLoader.LoadFromBlob"), [=]() { return LoadImageFromBlob(Outer, name, data); }), MoveTemp(CompletionCallback));
 }
 
 UTexture2D* UImageLoader::LoadImageFromDisk(UObject* Outer, const FString& ImagePath)
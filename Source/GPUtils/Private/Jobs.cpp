@@ -0,0 +1,394 @@
+#include <GPUtils/Jobs.h>
+
+#include <GPUtils/HopStats.h>
+
+#include <HAL/Event.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformMisc.h>
+#include <HAL/PlatformProcess.h>
+#include <HAL/PlatformTime.h>
+#include <HAL/Runnable.h>
+#include <HAL/RunnableThread.h>
+#include <Misc/ScopeLock.h>
+
+#include <atomic>
+
+static TAutoConsoleVariable<int32> CVarWorkers(
+	TEXT("GPUtils.Jobs.Workers"),
+	0,
+	TEXT("Number of job workers, read when the first job is launched. 0 - half of the worker threads the task graph spawns, so that both pools together don't oversubscribe the cores."),
+	ECVF_ReadOnly);
+
+class FJob
+{
+public:
+	TUniqueFunction<void()> work;
+	FJobHandle parent;
+	EJobPriority priority;
+
+	// Own work plus unfinished children.
+	std::atomic<int32> unfinished{ 1 };
+
+#if GPUTILS_HOP_STATS
+	uint64 enqueued = 0;
+#endif
+};
+
+namespace
+{
+	constexpr auto NumPriorities = static_cast<int32>(EJobPriority::Num);
+
+	// Ring buffer of jobs, pushed and popped at the back by its worker and stolen from the front by the others.
+	// The lock is only contended while a steal hits this deque.
+	class FJobDeque
+	{
+	public:
+		void Push(FJobHandle&& job)
+		{
+			FScopeLock scope(&lock);
+			if (count == items.Num())
+				Grow();
+			items[(head + count) & (items.Num() - 1)] = MoveTemp(job);
+			++count;
+		}
+
+		bool Pop(FJobHandle& job)
+		{
+			FScopeLock scope(&lock);
+			if (count == 0)
+				return false;
+			--count;
+			job = MoveTemp(items[(head + count) & (items.Num() - 1)]);
+			return true;
+		}
+
+		bool Steal(FJobHandle& job)
+		{
+			FScopeLock scope(&lock);
+			if (count == 0)
+				return false;
+			job = MoveTemp(items[head]);
+			head = (head + 1) & (items.Num() - 1);
+			--count;
+			return true;
+		}
+
+		void Reset()
+		{
+			FScopeLock scope(&lock);
+			items.Reset();
+			head = count = 0;
+		}
+
+	private:
+		FCriticalSection lock;
+		TArray<FJobHandle> items;
+		int32 head = 0;
+		int32 count = 0;
+
+		void Grow()
+		{
+			auto grown = TArray<FJobHandle>{};
+			grown.SetNum(FMath::Max(items.Num() * 2, 64));
+			for (auto i = 0; i < count; ++i)
+				grown[i] = MoveTemp(items[(head + i) & (items.Num() - 1)]);
+			items = MoveTemp(grown);
+			head = 0;
+		}
+	};
+
+	class FJobScheduler;
+
+	class FJobWorker final : public FRunnable
+	{
+	public:
+		FJobScheduler& scheduler;
+		int32 index;
+		FJobDeque deques[NumPriorities];
+		FEvent* wake;
+		FRunnableThread* thread = nullptr;
+		std::atomic<bool> sleeping{ false };
+
+		std::atomic<uint64> executed{ 0 };
+		std::atomic<uint64> steals{ 0 };
+		std::atomic<uint64> idleCycles{ 0 };
+
+		FJobWorker(FJobScheduler& scheduler_, int32 index_)
+			: scheduler(scheduler_)
+			, index(index_)
+			, wake(FPlatformProcess::GetSynchEventFromPool(false))
+		{
+		}
+
+		virtual ~FJobWorker() override { FPlatformProcess::ReturnSynchEventToPool(wake); }
+
+		virtual uint32 Run() override;
+	};
+
+#if GPUTILS_HOP_STATS
+	const FHopTag& HopTag(EJobPriority priority)
+	{
+		static const FHopTag tags[] = { FHopTag(TEXT("Jobs.High")), FHopTag(TEXT("Jobs.Normal")), FHopTag(TEXT("Jobs.Low")), };
+		return tags[static_cast<int32>(priority)];
+	}
+#endif
+
+	thread_local int32 workerIndex = INDEX_NONE;
+	thread_local FJobHandle currentJob;
+
+	// So that shutting down doesn't start the workers of a scheduler that was never used.
+	std::atomic<bool> schedulerCreated{ false };
+
+	class FJobScheduler
+	{
+	public:
+		static FJobScheduler& Get()
+		{
+			static FJobScheduler scheduler;
+			return scheduler;
+		}
+
+		FJobScheduler()
+		{
+			schedulerCreated = true;
+			// The task graph and the global thread pool already have a worker per core, these run alongside them.
+			const auto configured = CVarWorkers.GetValueOnAnyThread();
+			const auto num = configured > 0 ? configured : FMath::Max(FPlatformMisc::NumberOfWorkerThreadsToSpawn() / 2, 1);
+			for (auto i = 0; i < num; ++i)
+				workers.Add(MakeUnique<FJobWorker>(*this, i));
+			active = workers.Num();
+			for (auto& worker : workers)
+				worker->thread = FRunnableThread::Create(worker.Get(), *FString::Printf(TEXT("GPUtilsJobWorker %d"), worker->index), 0, TPri_SlightlyBelowNormal);
+		}
+
+		~FJobScheduler() { Shutdown(); }
+
+		void Push(FJobHandle&& job)
+		{
+			if (stopping)
+			{
+				Execute(job);
+				return;
+			}
+
+			// Jobs launched by a worker stay on it, the others are spread over the active workers.
+			const auto priority = static_cast<int32>(job->priority);
+			const auto target = workerIndex != INDEX_NONE ? workerIndex : static_cast<int32>(next.fetch_add(1, std::memory_order_relaxed) % uint32(active.load(std::memory_order_relaxed)));
+			workers[target]->deques[priority].Push(MoveTemp(job));
+			queued.fetch_add(1);
+			WakeOne();
+		}
+
+		// Runs one queued job on the calling thread, taking the highest priority first. Returns false when there was none.
+		bool RunOne()
+		{
+			auto job = FJobHandle{};
+			const auto self = workerIndex;
+			for (auto priority = 0; priority < NumPriorities && !job; ++priority)
+			{
+				if (self != INDEX_NONE && workers[self]->deques[priority].Pop(job))
+					break;
+
+				for (auto i = 1; i <= workers.Num(); ++i)
+				{
+					const auto victim = (FMath::Max(self, 0) + i) % workers.Num();
+					if (victim == self || !workers[victim]->deques[priority].Steal(job))
+						continue;
+					if (self != INDEX_NONE)
+						workers[self]->steals.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+			}
+
+			if (!job)
+				return false;
+
+			queued.fetch_sub(1);
+			Execute(job);
+			if (self != INDEX_NONE)
+				workers[self]->executed.fetch_add(1, std::memory_order_relaxed);
+			else
+				helped.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		uint32 Run(FJobWorker& worker)
+		{
+			workerIndex = worker.index;
+			while (!stopping)
+			{
+				// Workers over the limit sleep, the others steal what is left in their deques.
+				const auto enabled = worker.index < active.load(std::memory_order_relaxed);
+				if (enabled && RunOne())
+					continue;
+
+				// A push between the flag and the check either sees the flag and triggers the event, or is seen by the check.
+				worker.sleeping.store(true);
+				if ((enabled && queued.load() > 0) || stopping)
+				{
+					worker.sleeping.store(false);
+					continue;
+				}
+
+				const auto start = FPlatformTime::Cycles64();
+				worker.wake->Wait();
+				worker.idleCycles.fetch_add(FPlatformTime::Cycles64() - start, std::memory_order_relaxed);
+			}
+			return 0;
+		}
+
+		FJobStats GetStats(bool reset)
+		{
+			auto ret = FJobStats{};
+			ret.workers = active.load();
+			ret.queued = FMath::Max(queued.load(), 0);
+			ret.executed = reset ? helped.exchange(0) : helped.load();
+
+			auto idleCycles = uint64(0);
+			for (auto& worker : workers)
+			{
+				ret.executed += reset ? worker->executed.exchange(0) : worker->executed.load();
+				ret.steals += reset ? worker->steals.exchange(0) : worker->steals.load();
+				idleCycles += reset ? worker->idleCycles.exchange(0) : worker->idleCycles.load();
+			}
+			ret.idleMs = FPlatformTime::ToMilliseconds64(idleCycles);
+			return ret;
+		}
+
+		void SetLimit(int32 num)
+		{
+			active = num > 0 ? FMath::Min(num, workers.Num()) : workers.Num();
+
+			// Newly enabled workers pick up the queued jobs, disabled ones go back to sleep.
+			for (auto& worker : workers)
+			{
+				worker->sleeping.store(false);
+				worker->wake->Trigger();
+			}
+		}
+
+		void Shutdown()
+		{
+			if (stopping.exchange(true))
+				return;
+
+			for (auto& worker : workers)
+				worker->wake->Trigger();
+			for (auto& worker : workers)
+			{
+				worker->thread->WaitForCompletion();
+				delete worker->thread;
+				worker->thread = nullptr;
+			}
+
+			// Dropping the queued jobs would leave their parents unfinished forever and WaitForJob spinning. Children they launch run inline.
+			while (RunOne())
+				;
+			for (auto& worker : workers)
+				for (auto& deque : worker->deques)
+					deque.Reset();
+			queued = 0;
+		}
+
+	private:
+		TArray<TUniquePtr<FJobWorker>> workers;
+		std::atomic<int32> queued{ 0 };
+		std::atomic<uint32> next{ 0 };
+		std::atomic<uint64> helped{ 0 };
+		std::atomic<int32> active{ 0 };
+		std::atomic<bool> stopping{ false };
+
+		void WakeOne()
+		{
+			const auto num = active.load(std::memory_order_relaxed);
+			for (auto i = 0; i < num; ++i)
+			{
+				auto& worker = workers[i];
+				auto expected = true;
+				if (worker->sleeping.compare_exchange_strong(expected, false))
+				{
+					worker->wake->Trigger();
+					return;
+				}
+			}
+		}
+
+		static void Execute(const FJobHandle& job)
+		{
+			auto previous = MoveTemp(currentJob);
+			currentJob = job;
+			{
+				GPUTILS_HOP_SCOPE(HopTag(job->priority), job->enqueued);
+				job->work();
+			}
+			job->work = nullptr;
+			currentJob = MoveTemp(previous);
+
+			// The last one to finish among a job and its children completes it, then its parent's count goes down.
+			for (auto finished = job; finished && finished->unfinished.fetch_sub(1) == 1;)
+			{
+				auto parent = MoveTemp(finished->parent);
+				finished = MoveTemp(parent);
+			}
+		}
+	};
+
+	uint32 FJobWorker::Run()
+	{
+		return scheduler.Run(*this);
+	}
+}
+
+FJobHandle LaunchJob(TUniqueFunction<void()>&& work, EJobPriority priority, const FJobHandle& parent)
+{
+	auto job = MakeShared<FJob, ESPMode::ThreadSafe>();
+	job->work = MoveTemp(work);
+	job->priority = priority;
+#if GPUTILS_HOP_STATS
+	job->enqueued = FPlatformTime::Cycles64();
+#endif
+	if (parent)
+	{
+		checkf(!IsJobDone(parent), TEXT("Children can only be added to a job that isn't done yet."));
+		parent->unfinished.fetch_add(1);
+		job->parent = parent;
+	}
+
+	auto ret = job;
+	FJobScheduler::Get().Push(MoveTemp(job));
+	return ret;
+}
+
+const FJobHandle& GetCurrentJob()
+{
+	return currentJob;
+}
+
+bool IsJobDone(const FJobHandle& job)
+{
+	return !job || job->unfinished.load() == 0;
+}
+
+void WaitForJob(const FJobHandle& job)
+{
+	auto& scheduler = FJobScheduler::Get();
+	while (!IsJobDone(job))
+		if (!scheduler.RunOne())
+			FPlatformProcess::Yield();
+}
+
+FJobStats GetJobStats(bool reset)
+{
+	return FJobScheduler::Get().GetStats(reset);
+}
+
+void SetJobWorkerLimit(int32 num)
+{
+	FJobScheduler::Get().SetLimit(num);
+}
+
+void ShutdownJobs()
+{
+	if (schedulerCreated)
+		FJobScheduler::Get().Shutdown();
+}
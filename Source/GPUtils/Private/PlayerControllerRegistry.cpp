@@ -0,0 +1,63 @@
+#include <GPUtils/PlayerControllerRegistry.h>
+
+#include <Engine/World.h>
+#include <GameFramework/PlayerController.h>
+
+void UPlayerControllerRegistry::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	const auto world = GetWorld();
+	actorSpawned = world->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UPlayerControllerRegistry::OnActorSpawned));
+	for (auto it = world->GetPlayerControllerIterator(); it; ++it)
+		OnActorSpawned(it->Get());
+}
+
+void UPlayerControllerRegistry::Deinitialize()
+{
+	if (const auto world = GetWorld())
+		world->RemoveOnActorSpawnedHandler(actorSpawned);
+	controllers.Empty();
+	firstLocal = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UPlayerControllerRegistry::Refresh()
+{
+	const auto world = GetWorld();
+	if (controllers.Num() == world->GetNumPlayerControllers())
+		return;
+
+	for (auto it = world->GetPlayerControllerIterator(); it; ++it)
+		OnActorSpawned(it->Get());
+	controllers.RemoveAll([](const APlayerController* controller) { return !IsValid(controller); });
+	firstLocal = nullptr;
+}
+
+APlayerController* UPlayerControllerRegistry::GetFirstLocalController() const
+{
+	if (firstLocal == nullptr)
+	{
+		const auto found = controllers.FindByPredicate([](const APlayerController* controller) { return controller->IsLocalController(); });
+		firstLocal = found ? *found : nullptr;
+	}
+	return firstLocal;
+}
+
+void UPlayerControllerRegistry::OnActorSpawned(AActor* actor)
+{
+	const auto controller = Cast<APlayerController>(actor);
+	if (!IsValid(controller) || controllers.Contains(controller))
+		return;
+
+	controllers.Add(controller);
+	controller->OnEndPlay.AddUniqueDynamic(this, &UPlayerControllerRegistry::OnActorEndPlay);
+}
+
+void UPlayerControllerRegistry::OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason)
+{
+	controllers.RemoveSingle(static_cast<APlayerController*>(actor));
+	if (firstLocal == actor)
+		firstLocal = nullptr;
+}
@@ -0,0 +1,319 @@
+#include <GPUtils/QuickMatch.h>
+
+#include <GPUtils/HopStats.h>
+#include <GPUtils/Threads.h>
+
+#include <Engine/LocalPlayer.h>
+#include <GameFramework/GameSession.h>
+#include <HAL/PlatformTime.h>
+#include <HAL/RunnableThread.h>
+#include <IPAddress.h>
+#include <Misc/ScopeLock.h>
+#include <OnlineSubsystem.h>
+#include <Sockets.h>
+#include <SocketSubsystem.h>
+
+DEFINE_LOG_CATEGORY_STATIC(QuickMatch, Display, Display);
+
+FUdpEchoProbe::~FUdpEchoProbe()
+{
+	if (thread != nullptr)
+	{
+		thread->Kill(true);
+		delete thread;
+	}
+
+	for (auto& pair : pending)
+		pair.Value.promise.SetValue(INDEX_NONE);
+
+	if (socket != nullptr)
+	{
+		socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(socket);
+	}
+}
+
+TFuture<int32> FUdpEchoProbe::Probe(const FString& connectString)
+{
+	auto host = FString{};
+	auto hostPort = FString{};
+	if (!connectString.Split(TEXT(":"), &host, &hostPort, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+		host = connectString;
+
+	const auto socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	const auto address = socketSubsystem ? socketSubsystem->GetAddressFromString(host) : nullptr;
+	if (!address.IsValid())
+		return MakeFulfilledPromise<int32>(INDEX_NONE).GetFuture();
+	address->SetPort(port > 0 ? port : FCString::Atoi(*hostPort));
+
+	if (socket == nullptr)
+	{
+		socket = socketSubsystem->CreateSocket(NAME_DGram, TEXT("GPUtils session probe"), address->GetProtocolType());
+		if (socket == nullptr)
+			return MakeFulfilledPromise<int32>(INDEX_NONE).GetFuture();
+		socket->SetNonBlocking(true);
+		thread = FRunnableThread::Create(this, TEXT("GPUtilsSessionProbe"), 0, TPri_AboveNormal);
+	}
+
+	// Without the thread nothing would answer or time out the probe.
+	if (thread == nullptr)
+		return MakeFulfilledPromise<int32>(INDEX_NONE).GetFuture();
+
+	// Registered before sending, the reply may come back before SendTo returns.
+	auto future = TFuture<int32>{};
+	auto token = uint64(0);
+	{
+		FScopeLock scope(&lock);
+		token = ++nextToken;
+		auto& probe = pending.Add(token);
+		probe.sent = FPlatformTime::Cycles64();
+		probe.deadline = FPlatformTime::Seconds() + timeoutSeconds;
+		future = probe.promise.GetFuture();
+	}
+
+	auto bytes = 0;
+	if (!socket->SendTo(reinterpret_cast<const uint8*>(&token), sizeof(token), bytes, *address))
+	{
+		auto failed = FPending{};
+		{
+			FScopeLock scope(&lock);
+			pending.RemoveAndCopyValue(token, failed);
+		}
+		failed.promise.SetValue(INDEX_NONE);
+	}
+	return future;
+}
+
+uint32 FUdpEchoProbe::Run()
+{
+	while (!stopping)
+	{
+		// Wakes up at least every 50 ms to time probes out and notice Stop.
+		if (socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(50)))
+			Receive();
+		Expire();
+	}
+	return 0;
+}
+
+void FUdpEchoProbe::Receive()
+{
+	// Promises are fulfilled outside of the lock, their continuations run right away.
+	auto token = uint64(0);
+	auto bytes = 0;
+	while (socket->Recv(reinterpret_cast<uint8*>(&token), sizeof(token), bytes) && bytes > 0)
+	{
+		const auto received = FPlatformTime::Cycles64();
+		auto answered = FPending{};
+		{
+			FScopeLock scope(&lock);
+			if (bytes != sizeof(token) || !pending.RemoveAndCopyValue(token, answered))
+				continue;
+		}
+		answered.promise.SetValue(static_cast<int32>(FPlatformTime::ToMilliseconds64(received - answered.sent)));
+	}
+}
+
+void FUdpEchoProbe::Expire()
+{
+	auto expired = TArray<FPending>{};
+	{
+		FScopeLock scope(&lock);
+		const auto now = FPlatformTime::Seconds();
+		for (auto it = pending.CreateIterator(); it; ++it)
+		{
+			if (it.Value().deadline > now)
+				continue;
+			expired.Add(MoveTemp(it.Value()));
+			it.RemoveCurrent();
+		}
+	}
+
+	for (auto& probe : expired)
+		probe.promise.SetValue(INDEX_NONE);
+}
+
+UQuickMatchTask* UQuickMatchTask::QuickMatchAsync(UObject* worldContext, ULocalPlayer* player, const FSessionQuery& query, const FQuickMatchSettings& settings, FQuickMatchResultHandler callback)
+{
+	const auto probe = settings.echoPort > 0 ? MakeShared<FUdpEchoProbe>(settings.echoPort, settings.probeTimeoutSeconds) : TSharedPtr<FUdpEchoProbe>{};
+	return QuickMatchAsync(worldContext, player, query, settings, probe, callback);
+}
+
+UQuickMatchTask* UQuickMatchTask::QuickMatchAsync(UObject* worldContext_, ULocalPlayer* player_, const FSessionQuery& query, const FQuickMatchSettings& settings_, TSharedPtr<ISessionProbe> probe_, FQuickMatchResultHandler callback_)
+{
+	if (player_ == nullptr)
+	{
+		UE_LOG(QuickMatch, Error, TEXT("Player is invalid."));
+		callback_.ExecuteIfBound(EQuickMatchResult::InvalidPlayer);
+		return nullptr;
+	}
+
+	auto task = NewObject<UQuickMatchTask>();
+	task->AddToRoot();
+	task->worldContext = worldContext_;
+	task->player = player_;
+	task->settings = settings_;
+	task->probe = probe_;
+	task->callback = callback_;
+
+	auto searched = FFindSessionResultHandler{};
+	searched.BindUFunction(task, GET_FUNCTION_NAME_CHECKED(UQuickMatchTask, OnSearchComplete));
+	task->search = UFindSessionsTask::CreateSearch(query.lan, query.presence, query.timeoutInSeconds, query.maxResults, 0, {}, searched, query.subsystem);
+	task->search->FindSessionsAsync(player_->GetPreferredUniqueNetId().GetUniqueNetId());
+	return task;
+}
+
+FSessionResult UQuickMatchTask::GetSession() const
+{
+	return attempt > 0 ? search->GetSessionResults()[candidates[attempt - 1].id] : FSessionResult{};
+}
+
+static float Score(const FSessionResult& session, int32 rtt, const FQuickMatchSettings& settings)
+{
+	const auto fill = session.publicSlots > 0 ? float(session.publicSlots - session.openPublicSlots) / session.publicSlots : 0.f;
+	const auto preferred = !settings.preferredMap.IsEmpty() && session.mapName == settings.preferredMap;
+	return rtt - settings.fillWeight * fill - (preferred ? settings.mapBonus : 0.f);
+}
+
+void UQuickMatchTask::OnSearchComplete(EFindSessionsResult status)
+{
+	if (status != EFindSessionsResult::Success)
+	{
+		Finish(EQuickMatchResult::FailedToFindSessions);
+		return;
+	}
+
+	const auto& results = search->GetSessionResults();
+	for (const auto& session : results)
+		if (session.publicSlots == 0 || session.openPublicSlots > 0)
+			candidates.Add({ session.id, session.ping, });
+
+	candidates.Sort([&](const FCandidate& a, const FCandidate& b) { return a.rtt < b.rtt; });
+	if (candidates.Num() > settings.maxCandidates)
+		candidates.SetNum(FMath::Max(settings.maxCandidates, 1));
+
+	if (candidates.Num() == 0)
+	{
+		UE_LOG(QuickMatch, Log, TEXT("No session with open slots found."));
+		Finish(EQuickMatchResult::NoSessionFound);
+		return;
+	}
+
+	const auto onlineSubsystem = IOnlineSubsystem::Get(search->subsystem);
+	const auto sessions = onlineSubsystem ? onlineSubsystem->GetSessionInterface() : nullptr;
+
+	// Every candidate reports once, synchronously when it can't be probed. Replies hop back to the game thread, so ranking waits for the last one.
+	probing = candidates.Num();
+	for (auto i = 0; i < candidates.Num(); ++i)
+	{
+		auto connectString = FString{};
+		if (!probe.IsValid() || !sessions.IsValid() || !sessions->GetResolvedConnectString(search->search->SearchResults[candidates[i].id], NAME_GamePort, connectString))
+		{
+			OnProbed(i, candidates[i].rtt);
+			continue;
+		}
+
+		probe->Probe(connectString).Then([task = TWeakObjectPtr<UQuickMatchTask>(this), i](TFuture<int32> rtt)
+			{
+				ExecuteInGameThread(InstrumentHop(GPUTILS_HOP_TAG("QuickMatch.Probe"), [task, i, rtt = rtt.Get()]
+					{
+						if (task.IsValid())
+							task->OnProbed(i, rtt);
+					}));
+			});
+	}
+}
+
+void UQuickMatchTask::OnProbed(int32 index, int32 rtt)
+{
+	auto& candidate = candidates[index];
+	candidate.rtt = rtt != INDEX_NONE ? rtt : static_cast<int32>(settings.probeTimeoutSeconds * 1000);
+	candidate.score = Score(search->GetSessionResults()[candidate.id], candidate.rtt, settings);
+
+	if (--probing > 0)
+		return;
+
+	candidates.StableSort([](const FCandidate& a, const FCandidate& b) { return a.score < b.score; });
+	JoinNext();
+}
+
+void UQuickMatchTask::JoinNext()
+{
+	if (!player.IsValid())
+	{
+		UE_LOG(QuickMatch, Error, TEXT("Player is invalid."));
+		Finish(EQuickMatchResult::InvalidPlayer);
+		return;
+	}
+
+	// Gone when the world it belonged to was torn down while searching or probing.
+	if (!worldContext.IsValid())
+	{
+		UE_LOG(QuickMatch, Error, TEXT("World context is invalid."));
+		Finish(EQuickMatchResult::InvalidWorldContext);
+		return;
+	}
+
+	if (attempt == candidates.Num())
+	{
+		UE_LOG(QuickMatch, Warning, TEXT("Failed to join any of %d sessions."), candidates.Num());
+		Finish(EQuickMatchResult::FailedToJoinSession);
+		return;
+	}
+
+	const auto& candidate = candidates[attempt++];
+	UE_LOG(QuickMatch, Log, TEXT("Joining session %s, %d ms, score %.1f."), *search->GetSessionResults()[candidate.id].sessionId, candidate.rtt, candidate.score);
+
+	auto joined = FJoinSessionResultHandler{};
+	joined.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UQuickMatchTask, OnJoinComplete));
+	const auto started = attempt;
+	const auto task = search->JoinSessionAsync(worldContext.Get(), player.Get(), candidate.id, joined);
+
+	// The join may complete within the call and the next one start, which holds its own task then.
+	if (attempt == started)
+		joining = task;
+}
+
+void UQuickMatchTask::OnJoinComplete(EJoinSessionResult status)
+{
+	switch (status)
+	{
+	case EJoinSessionResult::Success:
+		Finish(EQuickMatchResult::Success);
+		return;
+	case EJoinSessionResult::SessionIsFull:
+	case EJoinSessionResult::SessionDoesNotExist:
+	case EJoinSessionResult::CouldNotRetrieveAddress:
+	case EJoinSessionResult::FailedToJoinSession:
+	case EJoinSessionResult::UnknownError:
+	{
+		// Subsystems may keep the failed session registered under its name, the next join would fail as already in session.
+		auto destroyed = FDestroySessionResultHandler{};
+		destroyed.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UQuickMatchTask, OnSessionDestroyed));
+		destroying = NewObject<UDestroySessionTask>(this);
+		destroying->callback = destroyed;
+		destroying->subsystem = search->subsystem;
+		destroying->DestroySessionAsync(GameSessionName);
+		return;
+	}
+	default:
+		Finish(EQuickMatchResult::FailedToJoinSession);
+		return;
+	}
+}
+
+void UQuickMatchTask::OnSessionDestroyed(EDestroySessionResult status)
+{
+	// Usually there was nothing left to destroy.
+	if (status != EDestroySessionResult::Success)
+		UE_LOG(QuickMatch, Verbose, TEXT("No session left behind by the failed join."));
+	JoinNext();
+}
+
+void UQuickMatchTask::Finish(EQuickMatchResult result)
+{
+	joining = nullptr;
+	destroying = nullptr;
+	RemoveFromRoot();
+	callback.ExecuteIfBound(result);
+}
@@ -0,0 +1,32 @@
+#include <GPUtils/Collect.h>
+#include <GPUtils/Range.h>
+
+// Compile-time checks of the constexpr part of the range library.
+namespace
+{
+    constexpr auto squares = Range::ToStaticArray<4>(Range::Make(0, 3) | [](int32 i) { return i * i; });
+    static_assert(squares[0] == 0 && squares[1] == 1 && squares[2] == 4 && squares[3] == 9, "Map over Range must be constexpr.");
+
+    static_assert(Range::Make(1, 10).Num() == 10, "Range::Num must be constexpr.");
+    static_assert(Range::Make(3, 2).Num() == 0, "Empty range must have no elements.");
+    static_assert(*Range::Make(5, 7).begin() == 5, "Range iteration must be constexpr.");
+    static_assert(!Range::Make(5, 4).begin(), "Empty range must start at its end.");
+    static_assert((Range::Make(0, 3) | [](int32 i) { return i + 1; } | [](int32 i) { return i * 2; }).Num() == 4, "Map must inherit the size of its input.");
+
+    struct EmptySource
+    {
+        constexpr int32 Num() const { return 0; }
+    };
+
+    static_assert(Range::Make<int32, 2>(0, 9).Num() == 5, "Compile-time step must be honored.");
+    static_assert(Range::Make<int32, -3>(9, 0).Num() == 4, "Negative compile-time step must walk down.");
+    static_assert(Range::Make(10, 0, -5).Num() == 3, "Negative runtime step must walk down.");
+    static_assert(Range::Make(0u, 10u, 3).Num() == 4, "Runtime step must be honored.");
+    static_assert(*(Range::Make(0, 100, 10).begin() + 3) == 30, "Stepped ranges must advance in one jump.");
+    static_assert(!(Range::Make(0, 100, 10).begin() + 11), "Advancing past the end must give the end.");
+    static_assert(*Range::Reverse(Range::Make(0, 9, 4)).begin() == 8, "Reverse must start at the last element.");
+    static_assert(Range::Reverse(Range::Make<int32, 2>(0, 9)).Num() == 5, "Reverse must keep the size.");
+    static_assert(Range::Indexes<uint32>(EmptySource{}).Num() == 0, "Indexes of an empty source must be empty.");
+    static_assert(!Range::Reverse(Range::Make(0, -1, 2)).begin(), "Reversing an empty range must start at its end.");
+    static_assert(!Range::Reverse(Range::Indexes<uint32>(EmptySource{})).begin(), "Reversing empty indexes must start at their end.");
+}
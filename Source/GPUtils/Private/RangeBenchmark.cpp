@@ -0,0 +1,245 @@
+#include <GPUtils/Range.h>
+#include <GPUtils/SpatialGrid.h>
+#include <GPUtils/Traversal.h>
+#include <GPUtils/View.h>
+
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+#include <Misc/App.h>
+#include <Misc/FileHelper.h>
+#include <Math/RandomStream.h>
+#include <Misc/Paths.h>
+
+#if !UE_BUILD_SHIPPING
+
+// Compares the range library with the equivalent hand-written loops and reports the result as JSON.
+// Runs headless, e.g. on a Linux build machine:
+// UE4Editor-Cmd Project.uproject -nullrhi -unattended -ExecCmds="GPUtils.BenchmarkRanges Saved/RangeBenchmark.json, Quit"
+namespace
+{
+    volatile double sink = 0;
+
+    // Integer sums wrap in the unsigned type of the same width, so overflow is well defined without changing what the loops vectorize to.
+    template <class TValue>
+    using Sum = typename std::conditional_t<std::is_integral_v<TValue>, std::make_unsigned<TValue>, std::type_identity<TValue>>::type;
+
+    struct Result
+    {
+        FString name;
+        FString type;
+        int32 elements;
+        double rangeNs;
+        double rawNs;
+
+        // 0 when the case doesn't iterate a range.
+        SIZE_T iteratorSize = 0;
+
+        // Whether the raw loop is one the compiler auto-vectorizes, so that the ratio hints at whether the range loop did too.
+        bool vectorizable = false;
+    };
+
+    // Best of several runs, so one-off hiccups (page faults, preemption) don't end up in the numbers.
+    template <class TFunctor>
+    double NsPerElement(int32 elements, const TFunctor& functor)
+    {
+        auto best = TNumericLimits<double>::Max();
+        for (auto run = 0; run < 5; ++run)
+        {
+            const auto start = FPlatformTime::Seconds();
+            sink = sink + static_cast<double>(functor());
+            best = FMath::Min(best, FPlatformTime::Seconds() - start);
+        }
+        return best * 1e9 / FMath::Max(elements, 1);
+    }
+
+    template <class TValue>
+    const TCHAR* TypeName();
+
+    template <> const TCHAR* TypeName<int32>() { return TEXT("int32"); }
+    template <> const TCHAR* TypeName<int64>() { return TEXT("int64"); }
+    template <> const TCHAR* TypeName<float>() { return TEXT("float"); }
+    template <> const TCHAR* TypeName<double>() { return TEXT("double"); }
+
+    template <class TValue>
+    void BenchmarkType(int32 num, TArray<Result>& results)
+    {
+        const auto type = TypeName<TValue>();
+        const auto last = static_cast<TValue>(num - 1);
+
+        {
+            const auto range = Range::Make<TValue>(0, last);
+            results.Add({ TEXT("Make"), type, num,
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i : range) sum += i; return sum; }),
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i = TValue{}; i <= last; ++i) sum += i; return sum; }),
+                sizeof(range.begin()), true, });
+        }
+
+        {
+            const auto range = Range::Make<TValue>(0, last) | [](TValue i) { return i * 3; } | [](TValue i) { return i + 1; };
+            results.Add({ TEXT("Map"), type, num,
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i : range) sum += i; return sum; }),
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i = TValue{}; i <= last; ++i) sum += i * 3 + 1; return sum; }),
+                sizeof(range.begin()), true, });
+        }
+
+        {
+            const auto side = static_cast<int32>(FMath::Sqrt(static_cast<float>(num)));
+            const auto range = Range::Make<TValue>(0, static_cast<TValue>(side - 1)) * Range::Make<TValue>(0, static_cast<TValue>(side - 1));
+            results.Add({ TEXT("Join"), type, side * side,
+                NsPerElement(side * side, [&] { auto sum = Sum<TValue>{}; for (auto t : range) sum += t.template Get<0>() * t.template Get<1>(); return sum; }),
+                NsPerElement(side * side, [&]
+                    {
+                        auto sum = Sum<TValue>{};
+                        for (auto a = 0; a < side; ++a)
+                            for (auto b = 0; b < side; ++b)
+                                sum += static_cast<TValue>(a) * static_cast<TValue>(b);
+                        return sum;
+                    }),
+                sizeof(range.begin()), true, });
+        }
+
+        auto data = TArray<TValue>{};
+        data.SetNumUninitialized(num);
+        for (auto i = 0; i < num; ++i)
+            data[i] = static_cast<TValue>(i % 100);
+
+        {
+            const auto range = Range::Indexes<int32>(data);
+            results.Add({ TEXT("Indexes"), type, num,
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i : range) sum += data[i]; return sum; }),
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i = 0; i < num; ++i) sum += data[i]; return sum; }),
+                sizeof(range.begin()), true, });
+        }
+
+        {
+            const auto range = Range::View(data);
+            results.Add({ TEXT("View"), type, num,
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto v : range) sum += v; return sum; }),
+                NsPerElement(num, [&] { auto sum = Sum<TValue>{}; for (auto i = 0; i < num; ++i) sum += data[i]; return sum; }),
+                sizeof(range.begin()), true, });
+        }
+
+        // Sweeps over a 2D grid stored row-major. The baseline is the contiguous row-major loop, so the ratio shows how much each order pays for its locality.
+        {
+            const auto side = static_cast<int32>(FMath::Sqrt(static_cast<float>(num)));
+            const auto grid = Range::Make(0, side - 1) * Range::Make(0, side - 1);
+            const auto rowMajor = [&] { auto sum = Sum<TValue>{}; for (auto i = 0; i < side * side; ++i) sum += data[i]; return sum; };
+            const auto add = [&](const TCHAR* name, const auto& range, bool transposed)
+            {
+                results.Add({ name, type, side * side,
+                    NsPerElement(side * side, [&]
+                        {
+                            auto sum = Sum<TValue>{};
+                            for (auto t : range)
+                                sum += transposed ? data[t.template Get<1>() * side + t.template Get<0>()] : data[t.template Get<0>() * side + t.template Get<1>()];
+                            return sum;
+                        }),
+                    NsPerElement(side * side, rowMajor),
+                    sizeof(range.begin()), });
+            };
+
+            add(TEXT("Traversal.Join"), grid, false);
+            add(TEXT("Traversal.Strided"), grid, true);
+            add(TEXT("Traversal.Tiled"), Range::Tiled(grid, 8), true);
+            add(TEXT("Traversal.Morton"), Range::Morton(grid), true);
+            add(TEXT("Traversal.Hilbert"), Range::Hilbert(grid), true);
+        }
+    }
+
+    // Sphere queries against the spatial grid versus testing every location. Times are per query, elements is the number of indexed points.
+    void BenchmarkSpatial(int32 num, TArray<Result>& results)
+    {
+        constexpr auto extent = 100000.f;
+        constexpr auto radius = 2000.f;
+        constexpr auto queries = 256;
+
+        auto random = FRandomStream{ num };
+        auto locations = TArray<FVector>{};
+        auto grid = Spatial::Grid<int32>{ radius };
+        for (auto i = 0; i < num; ++i)
+        {
+            locations.Emplace(random.FRandRange(0.f, extent), random.FRandRange(0.f, extent), random.FRandRange(0.f, 1000.f));
+            grid.Add(i, locations.Last());
+        }
+
+        auto spheres = TArray<Spatial::Sphere>{};
+        for (auto i = 0; i < queries; ++i)
+            spheres.Add({ FVector{ random.FRandRange(0.f, extent), random.FRandRange(0.f, extent), 500.f }, radius, });
+
+        results.Add({ TEXT("Spatial.Sphere"), TEXT("grid"), num,
+            NsPerElement(queries, [&]
+                {
+                    auto found = 0;
+                    for (const auto& sphere : spheres)
+                        grid.ForEach(sphere, [&](int32) { ++found; });
+                    return found;
+                }),
+            NsPerElement(queries, [&]
+                {
+                    auto found = 0;
+                    for (const auto& sphere : spheres)
+                        for (const auto& location : locations)
+                            found += sphere.Contains(location);
+                    return found;
+                }),
+        });
+    }
+
+    // likelyVectorized is a guess from timings, not what the compiler did: on the cases whose raw loop auto-vectorizes, a range loop within 25%
+    // of it most likely vectorized too. Confirm with the compiler's vectorization report (-Rpass=loop-vectorize, /Qvec-report:2) when it matters.
+    FString ToJson(const TArray<Result>& results)
+    {
+        auto ret = FString::Printf(TEXT("{\n  \"build\": \"%s\",\n  \"platform\": \"%s\",\n  \"cases\": [\n"),
+            LexToString(FApp::GetBuildConfiguration()), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+
+        for (auto i = 0; i < results.Num(); ++i)
+        {
+            const auto& result = results[i];
+            const auto ratio = result.rangeNs / FMath::Max(result.rawNs, 1e-6);
+            auto optional = FString{};
+            if (result.iteratorSize > 0)
+                optional += FString::Printf(TEXT(", \"iteratorSize\": %d"), static_cast<int32>(result.iteratorSize));
+            if (result.vectorizable)
+                optional += FString::Printf(TEXT(", \"likelyVectorized\": %s"), ratio <= 1.25 ? TEXT("true") : TEXT("false"));
+
+            ret += FString::Printf(
+                TEXT("    { \"name\": \"%s\", \"type\": \"%s\", \"elements\": %d, \"rangeNsPerElement\": %.4f, \"rawNsPerElement\": %.4f, \"ratio\": %.3f%s }%s\n"),
+                *result.name, *result.type, result.elements, result.rangeNs, result.rawNs, ratio, *optional, i + 1 < results.Num() ? TEXT(",") : TEXT(""));
+        }
+
+        return ret + TEXT("  ]\n}\n");
+    }
+
+    void BenchmarkRanges(const TArray<FString>& args)
+    {
+        auto results = TArray<Result>{};
+        for (const auto num : { 1 << 10, 1 << 16, 1 << 20, })
+        {
+            BenchmarkType<int32>(num, results);
+            BenchmarkType<int64>(num, results);
+            BenchmarkType<float>(num, results);
+            BenchmarkType<double>(num, results);
+        }
+
+        for (const auto num : { 1000, 10000, 100000, })
+            BenchmarkSpatial(num, results);
+
+        const auto json = ToJson(results);
+        UE_LOG(LogTemp, Display, TEXT("Range benchmark:\n%s"), *json);
+
+        if (args.Num() > 0)
+        {
+            const auto path = FPaths::IsRelative(args[0]) ? FPaths::Combine(FPaths::ProjectDir(), args[0]) : args[0];
+            if (!FFileHelper::SaveStringToFile(json, *path))
+                UE_LOG(LogTemp, Error, TEXT("Failed to write the range benchmark to %s"), *path);
+        }
+    }
+
+    FAutoConsoleCommand BenchmarkRangesCommand(
+        TEXT("GPUtils.BenchmarkRanges"),
+        TEXT("Compares Range library loops with hand-written ones. Optional argument: path of the JSON report."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkRanges));
+}
+
+#endif
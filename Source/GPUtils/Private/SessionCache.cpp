@@ -0,0 +1,189 @@
+#include <GPUtils/SessionCache.h>
+
+#include <Engine/LocalPlayer.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+
+DEFINE_LOG_CATEGORY_STATIC(SessionCache, Display, Display);
+
+static TAutoConsoleVariable<float> CVarTTLSeconds(
+	TEXT("GPUtils.SessionCache.TTLSeconds"),
+	30.f,
+	TEXT("How long cached session search results stay fresh in seconds. Subscribing to stale ones searches again in the background."));
+
+static TAutoConsoleVariable<int32> CVarPingToleranceMs(
+	TEXT("GPUtils.SessionCache.PingToleranceMs"),
+	20,
+	TEXT("How far a session's ping may move from the one last reported before a refresh reports the session as updated."));
+
+static FString GetSignature(const FSessionQuery& query)
+{
+	auto ret = FString::Printf(TEXT("%s:%d:%d:%d"), *query.subsystem.ToString(), query.lan, query.presence, query.maxResults);
+
+	// Sorted, the same settings added in another order are the same query.
+	auto settings = query.settings;
+	settings.KeySort(FNameLexicalLess());
+	for (const auto& pair : settings)
+		ret += FString::Printf(TEXT(":%s=%s"), *pair.Key.ToString(), *pair.Value);
+	return ret;
+}
+
+// Ping jitters from one search to the next, only a move past the tolerance counts as a change.
+static bool IsSameSession(const FSessionResult& a, const FSessionResult& b)
+{
+	return a.mapName == b.mapName
+		&& a.ownerName == b.ownerName
+		&& FMath::Abs(a.ping - b.ping) <= CVarPingToleranceMs.GetValueOnGameThread()
+		&& a.publicSlots == b.publicSlots
+		&& a.openPublicSlots == b.openPublicSlots
+		&& a.privateSlots == b.privateSlots
+		&& a.openPrivateSlots == b.openPrivateSlots;
+}
+
+void USessionCacheEntry::Refresh(ULocalPlayer* player)
+{
+	if (refreshing != nullptr)
+		return;
+
+	if (player == nullptr)
+	{
+		UE_LOG(SessionCache, Error, TEXT("Player is invalid."));
+		return;
+	}
+
+	auto onBatch = FSessionBatchHandler{};
+	onBatch.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(USessionCacheEntry, OnBatch));
+	auto callback = FFindSessionResultHandler{};
+	callback.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(USessionCacheEntry, OnComplete));
+
+	// Set before starting, the search may report right away.
+	found.Reset();
+	refreshing = UFindSessionsTask::CreateSearch(query.lan, query.presence, query.timeoutInSeconds, query.maxResults, 0, onBatch, callback, query.subsystem);
+	for (const auto& pair : query.settings)
+		refreshing->search->QuerySettings.Set(pair.Key, pair.Value, EOnlineComparisonOp::Equals);
+	refreshing->FindSessionsAsync(player->GetPreferredUniqueNetId().GetUniqueNetId());
+}
+
+bool USessionCacheEntry::IsStale() const
+{
+	return refreshedAt == 0 || FPlatformTime::Seconds() - refreshedAt > CVarTTLSeconds.GetValueOnGameThread();
+}
+
+void USessionCacheEntry::OnBatch(const TArray<FSessionResult>& batch)
+{
+	for (const auto& session : batch)
+	{
+		found.Add(session.sessionId);
+
+		const auto index = sessions.IndexOfByPredicate([&](const FSessionResult& cached) { return cached.sessionId == session.sessionId; });
+		if (index == INDEX_NONE)
+		{
+			sessions.Add(session);
+			sources.Add(refreshing);
+			Broadcast(ESessionChange::Added, session);
+			continue;
+		}
+
+		// Unchanged rows are still moved to the new search, so that joins use fresh search results and old searches can be released. They keep the
+		// ping subscribers last heard of, so that a slow drift is reported once it adds up past the tolerance.
+		const auto changed = !IsSameSession(sessions[index], session);
+		const auto reportedPing = sessions[index].ping;
+		sessions[index] = session;
+		sources[index] = refreshing;
+		if (changed)
+			Broadcast(ESessionChange::Updated, session);
+		else
+			sessions[index].ping = reportedPing;
+	}
+}
+
+void USessionCacheEntry::OnComplete(EFindSessionsResult status)
+{
+	refreshing = nullptr;
+	if (status != EFindSessionsResult::Success)
+	{
+		UE_LOG(SessionCache, Warning, TEXT("Refreshing sessions failed, keeping the %d cached ones."), sessions.Num());
+		return;
+	}
+
+	refreshedAt = FPlatformTime::Seconds();
+	for (auto i = sessions.Num() - 1; i >= 0; --i)
+	{
+		if (found.Contains(sessions[i].sessionId))
+			continue;
+
+		const auto removed = sessions[i];
+		sessions.RemoveAt(i);
+		sources.RemoveAt(i);
+		Broadcast(ESessionChange::Removed, removed);
+	}
+	found.Reset();
+}
+
+void USessionCacheEntry::Broadcast(ESessionChange change, const FSessionResult& session) const
+{
+	// Handlers may unsubscribe while being called.
+	for (const auto& handler : TArray<FSessionChangeHandler>(handlers))
+		handler.ExecuteIfBound(change, session);
+}
+
+void USessionCache::Subscribe(ULocalPlayer* player, const FSessionQuery& query, FSessionChangeHandler handler)
+{
+	const auto entry = FindOrAddEntry(query);
+	entry->handlers.RemoveAll([](const FSessionChangeHandler& subscribed) { return !subscribed.IsBound(); });
+	entry->handlers.Add(handler);
+
+	for (const auto& session : TArray<FSessionResult>(entry->sessions))
+		handler.ExecuteIfBound(ESessionChange::Added, session);
+
+	if (entry->IsStale())
+		entry->Refresh(player);
+}
+
+void USessionCache::Unsubscribe(const FSessionQuery& query, FSessionChangeHandler handler)
+{
+	if (const auto entry = entries.FindRef(GetSignature(query)))
+		entry->handlers.Remove(handler);
+}
+
+void USessionCache::Refresh(ULocalPlayer* player, const FSessionQuery& query)
+{
+	FindOrAddEntry(query)->Refresh(player);
+}
+
+TArray<FSessionResult> USessionCache::GetCachedSessions(const FSessionQuery& query) const
+{
+	const auto entry = entries.FindRef(GetSignature(query));
+	return entry ? entry->sessions : TArray<FSessionResult>{};
+}
+
+void USessionCache::Invalidate()
+{
+	for (const auto& pair : entries)
+		pair.Value->refreshedAt = 0;
+}
+
+void USessionCache::JoinSessionAsync(UObject* worldContext, ULocalPlayer* player, const FSessionQuery& query, const FString& sessionId, FJoinSessionResultHandler callback)
+{
+	const auto entry = entries.FindRef(GetSignature(query));
+	const auto index = entry ? entry->sessions.IndexOfByPredicate([&](const FSessionResult& cached) { return cached.sessionId == sessionId; }) : INDEX_NONE;
+	if (index == INDEX_NONE)
+	{
+		UE_LOG(SessionCache, Error, TEXT("Session %s isn't cached."), *sessionId);
+		callback.ExecuteIfBound(EJoinSessionResult::SessionDoesNotExist);
+		return;
+	}
+
+	entry->sources[index]->JoinSessionAsync(worldContext, player, entry->sessions[index].id, callback);
+}
+
+USessionCacheEntry* USessionCache::FindOrAddEntry(const FSessionQuery& query)
+{
+	auto& entry = entries.FindOrAdd(GetSignature(query));
+	if (entry == nullptr)
+	{
+		entry = NewObject<USessionCacheEntry>(this);
+		entry->query = query;
+	}
+	return entry;
+}
@@ -0,0 +1,173 @@
+#include <GPUtils/QuickMatch.h>
+
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+#include <HAL/Runnable.h>
+#include <HAL/RunnableThread.h>
+#include <IPAddress.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <Sockets.h>
+#include <SocketSubsystem.h>
+
+#include <atomic>
+
+#if !UE_BUILD_SHIPPING
+
+// Stand-ins for session hosts, to exercise quick-match probing without any, and a benchmark of FUdpEchoProbe reported as JSON:
+// GPUtils.BenchmarkSessionProbe [probes] [path] - probes a loopback echo service that many times at once, and the fake probe for the overhead.
+namespace
+{
+    // Sends every datagram on a loopback port back where it came from, like the echo service FUdpEchoProbe expects on hosts.
+    class FUdpEchoServer final : public FRunnable
+    {
+    public:
+        FUdpEchoServer()
+        {
+            const auto socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+            const auto address = socketSubsystem->CreateInternetAddr();
+            address->SetLoopbackAddress();
+            address->SetPort(0);
+
+            socket = socketSubsystem->CreateSocket(NAME_DGram, TEXT("GPUtils echo server"), address->GetProtocolType());
+            if (socket == nullptr || !socket->Bind(*address))
+                return;
+            port = socket->GetPortNo();
+            thread = FRunnableThread::Create(this, TEXT("GPUtilsEchoServer"));
+        }
+
+        virtual ~FUdpEchoServer() override
+        {
+            if (thread != nullptr)
+            {
+                thread->Kill(true);
+                delete thread;
+            }
+
+            if (socket != nullptr)
+            {
+                socket->Close();
+                ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(socket);
+            }
+        }
+
+        // 0 when the server couldn't start.
+        int32 GetPort() const { return thread != nullptr ? port : 0; }
+
+        virtual uint32 Run() override
+        {
+            const auto from = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+            uint8 buffer[512];
+            while (!stopping)
+            {
+                if (!socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(50)))
+                    continue;
+
+                auto received = 0;
+                auto sent = 0;
+                if (socket->RecvFrom(buffer, sizeof(buffer), received, *from) && received > 0)
+                    socket->SendTo(buffer, received, sent, *from);
+            }
+            return 0;
+        }
+
+        virtual void Stop() override { stopping = true; }
+
+    private:
+        FSocket* socket = nullptr;
+        FRunnableThread* thread = nullptr;
+        int32 port = 0;
+        std::atomic<bool> stopping{ false };
+    };
+
+    // Answers right away with a fixed round trip per connect string, connect strings it doesn't know like a host that's down.
+    class FFakeSessionProbe final : public ISessionProbe
+    {
+    public:
+        explicit FFakeSessionProbe(TMap<FString, int32> rtts_) : rtts(MoveTemp(rtts_)) {}
+
+        virtual TFuture<int32> Probe(const FString& connectString) override
+        {
+            const auto rtt = rtts.Find(connectString);
+            return MakeFulfilledPromise<int32>(rtt != nullptr ? *rtt : INDEX_NONE).GetFuture();
+        }
+
+    private:
+        TMap<FString, int32> rtts;
+    };
+
+    struct Result
+    {
+        const TCHAR* name;
+        int32 answered;
+        double totalMs;
+        int32 maxRttMs;
+    };
+
+    // Starts all the probes at once and waits for every one to report, answered or timed out.
+    Result Measure(const TCHAR* name, ISessionProbe& probe, const FString& connectString, int32 probes)
+    {
+        const auto start = FPlatformTime::Seconds();
+        auto futures = TArray<TFuture<int32>>{};
+        for (auto i = 0; i < probes; ++i)
+            futures.Add(probe.Probe(connectString));
+
+        auto ret = Result{ name, 0, 0, 0, };
+        for (auto& future : futures)
+        {
+            const auto rtt = future.Get();
+            ret.answered += rtt != INDEX_NONE;
+            ret.maxRttMs = FMath::Max(ret.maxRttMs, rtt);
+        }
+        ret.totalMs = (FPlatformTime::Seconds() - start) * 1000;
+        return ret;
+    }
+
+    void BenchmarkSessionProbe(const TArray<FString>& args)
+    {
+        const auto probes = args.Num() > 0 ? FMath::Max(FCString::Atoi(*args[0]), 1) : 64;
+
+        const auto server = MakeUnique<FUdpEchoServer>();
+        if (server->GetPort() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to start the echo server."));
+            return;
+        }
+
+        const auto connectString = FString::Printf(TEXT("127.0.0.1:%d"), server->GetPort());
+        auto results = TArray<Result>{};
+        {
+            auto probe = FUdpEchoProbe{ 0, 1.f };
+            results.Add(Measure(TEXT("UdpEcho"), probe, connectString, probes));
+        }
+        {
+            auto probe = FFakeSessionProbe{ { { connectString, 1 } } };
+            results.Add(Measure(TEXT("Fake"), probe, connectString, probes));
+        }
+
+        auto json = FString::Printf(TEXT("{\n  \"probes\": %d,\n  \"cases\": [\n"), probes);
+        for (auto i = 0; i < results.Num(); ++i)
+        {
+            const auto& result = results[i];
+            json += FString::Printf(TEXT("    { \"name\": \"%s\", \"answered\": %d, \"totalMs\": %.3f, \"maxRttMs\": %d }%s\n"),
+                result.name, result.answered, result.totalMs, result.maxRttMs, i + 1 < results.Num() ? TEXT(",") : TEXT(""));
+        }
+        json += TEXT("  ]\n}\n");
+        UE_LOG(LogTemp, Display, TEXT("Session probe benchmark:\n%s"), *json);
+
+        if (args.Num() > 1)
+        {
+            const auto path = FPaths::IsRelative(args[1]) ? FPaths::Combine(FPaths::ProjectDir(), args[1]) : args[1];
+            if (!FFileHelper::SaveStringToFile(json, *path))
+                UE_LOG(LogTemp, Error, TEXT("Failed to write the session probe benchmark to %s"), *path);
+        }
+    }
+
+    FAutoConsoleCommand BenchmarkSessionProbeCommand(
+        TEXT("GPUtils.BenchmarkSessionProbe"),
+        TEXT("Probes a loopback UDP echo service with FUdpEchoProbe, all probes at once, and a fake probe for the overhead. Arguments: probes, path of the JSON report."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkSessionProbe));
+}
+
+#endif
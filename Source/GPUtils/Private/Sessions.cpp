@@ -1,21 +1,35 @@
 #include <GPUtils/Sessions.h>
 
+#include <GPUtils/Coroutines.h>
 #include <GPUtils/PlayerControllerRange.h>
-#include <GPUtils/Range.h>
 
+#include <Containers/Ticker.h>
 #include <GameFramework/GameSession.h>
 #include <Engine/LocalPlayer.h>
 #include <Engine/World.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
 #include <Kismet/GameplayStatics.h>
 #include <OnlineSessionSettings.h>
 #include <OnlineSubsystem.h>
 
 DEFINE_LOG_CATEGORY_STATIC(Sessions, Display, Display);
 
+// Only touched on the game thread.
+static FJoinLatencyStats joinLatency;
+
+FJoinLatencyStats GetJoinLatencyStats(bool reset)
+{
+	const auto ret = joinLatency;
+	if (reset)
+		joinLatency = {};
+	return ret;
+}
+
 template <class TError, class TCallback>
-static IOnlineSessionPtr GetSessionsInterface(const TCallback& callback, TError ossNotFound, TError siNotFound)
+static IOnlineSessionPtr GetSessionsInterface(const TCallback& callback, TError ossNotFound, TError siNotFound, FName subsystem = NAME_None)
 {
-	const auto onlineSubsystem = IOnlineSubsystem::Get();
+	const auto onlineSubsystem = IOnlineSubsystem::Get(subsystem);
 	if (!onlineSubsystem)
 	{
 		UE_LOG(Sessions, Error, TEXT("Online subsystem not found."));
@@ -33,29 +47,90 @@ static IOnlineSessionPtr GetSessionsInterface(const TCallback& callback, TError
 	return sessions;
 }
 
-FString USessionDetails::GetMapName() const
+// Creates the session, then starts it.
+static Coro::Task<> HostSession(IOnlineSessionPtr sessions, TSharedPtr<const FUniqueNetId> userId, FName name, FOnlineSessionSettings settings, FSessionStartResultHandler callback)
 {
-	const auto found = sessions->search->SearchResults[id].Session.SessionSettings.Settings.Find(SETTING_MAPNAME);
-	if (found == nullptr)
-		return "";
-	FString ret;
-	found->Data.GetValue(ret);
+	sessions->DestroySession(name); // Todo: remove
+
+	const auto created = co_await Coro::WaitFor<FName, bool>(
+		[&](auto&& resume)
+		{
+			const auto handle = sessions->AddOnCreateSessionCompleteDelegate_Handle(FOnCreateSessionCompleteDelegate::CreateLambda(MoveTemp(resume)));
+			sessions->CreateSession(*userId, name, settings);
+			return handle;
+		},
+		[&](FDelegateHandle handle) { sessions->ClearOnCreateSessionCompleteDelegate_Handle(handle); });
+
+	if (!created.Get<1>())
+	{
+		UE_LOG(Sessions, Error, TEXT("Failed to create a session."));
+		callback.ExecuteIfBound(ESessionCreationResult::FailedToCreateSession);
+		co_return;
+	}
+
+	const auto started = co_await Coro::WaitFor<FName, bool>(
+		[&](auto&& resume)
+		{
+			const auto handle = sessions->AddOnStartSessionCompleteDelegate_Handle(FOnStartSessionCompleteDelegate::CreateLambda(MoveTemp(resume)));
+			sessions->StartSession(name);
+			return handle;
+		},
+		[&](FDelegateHandle handle) { sessions->ClearOnStartSessionCompleteDelegate_Handle(handle); });
+
+	if (!started.Get<1>())
+	{
+		sessions->DestroySession(name);
+		UE_LOG(Sessions, Error, TEXT("Failed to start session."));
+		callback.ExecuteIfBound(ESessionCreationResult::FailedToStartSession);
+		co_return;
+	}
+
+	callback.ExecuteIfBound(ESessionCreationResult::Success);
+}
+
+static FSessionResult MakeSessionResult(int32 id, const FOnlineSessionSearchResult& result)
+{
+	auto ret = FSessionResult{};
+	ret.id = id;
+	ret.sessionId = result.GetSessionIdStr();
+	if (const auto found = result.Session.SessionSettings.Settings.Find(SETTING_MAPNAME))
+		found->Data.GetValue(ret.mapName);
+	ret.ownerName = result.Session.OwningUserName;
+	ret.ping = result.PingInMs;
+	ret.publicSlots = result.Session.SessionSettings.NumPublicConnections;
+	ret.openPublicSlots = result.Session.NumOpenPublicConnections;
+	ret.privateSlots = result.Session.SessionSettings.NumPrivateConnections;
+	ret.openPrivateSlots = result.Session.NumOpenPrivateConnections;
 	return ret;
 }
 
+FString USessionDetails::GetMapName() const
+{
+	return result.mapName;
+}
+
 FString USessionDetails::GetOwnerName() const
 {
-	return sessions->search->SearchResults[id].Session.OwningUserName;
+	return result.ownerName;
 }
 
 int32 USessionDetails::GetPing() const
 {
-	return sessions->search->SearchResults[id].PingInMs;
+	return result.ping;
 }
 
 void USessionDetails::JoinAsync(UObject* worldContext, ULocalPlayer* player, FJoinSessionResultHandler callback)
 {
-	sessions->JoinSessionAsync(worldContext, player, id, callback);
+	// The task may have searched again since, the session's index is only valid if it's still among the results.
+	const auto index = sessions->GetSessionResults().IndexOfByPredicate([&](const FSessionResult& current) { return current.sessionId == result.sessionId; });
+	if (index == INDEX_NONE)
+	{
+		UE_LOG(Sessions, Error, TEXT("Session %s isn't among the search results anymore."), *result.sessionId);
+		callback.ExecuteIfBound(EJoinSessionResult::SessionDoesNotExist);
+		return;
+	}
+
+	sessions->JoinSessionAsync(worldContext, player, index, callback);
 }
 
 void UCreateSessionTask::HostSessionAsync(ULocalPlayer* player, FString name, bool lan, bool usesPresence, int32 playersLimit, FSessionStartResultHandler callback)
@@ -96,56 +171,148 @@ void UCreateSessionTask::HostSessionAsync(TSharedPtr<const FUniqueNetId> userId,
 	if (!sessions.IsValid())
 		return;
 
-	auto task = NewObject<UCreateSessionTask>();
-
-	if (callback.IsBound())
-		task->callback = callback;
-
-	const auto delegate = FOnCreateSessionCompleteDelegate::CreateUObject(task, &UCreateSessionTask::OnCreateSessionComplete);
-	task->next = sessions->AddOnCreateSessionCompleteDelegate_Handle(delegate);
-
-	sessions->DestroySession(name); // Todo: remove
-	sessions->CreateSession(*userId, name, settings);
+	HostSession(sessions, userId, name, settings, callback).Start();
 }
 
-void UCreateSessionTask::OnCreateSessionComplete(FName name, bool successful)
+// Runs the searches of each sessions interface one after the other, in request order. Subsystems only run one search at a time and don't say which
+// one a completion belongs to, so the completion is routed to the task whose search was running, and only then is the next one started.
+class FSessionSearchQueue
 {
-	auto sessions = GetSessionsInterface(callback, ESessionCreationResult::OnlineSubsystemNotFound, ESessionCreationResult::SessionsInterfaceNotFound);
-	if (!sessions.IsValid())
-		return;
+public:
+	static void Enqueue(IOnlineSessionPtr sessions, UFindSessionsTask* task, TSharedPtr<const FUniqueNetId> userId)
+	{
+		auto& lane = lanes.FindOrAdd(sessions.Get());
+		lane.sessions = sessions;
+		lane.queued.Add({ task, MoveTemp(userId), });
+		StartNext(sessions.Get());
+	}
 
-	sessions->ClearOnCreateSessionCompleteDelegate_Handle(next);
+	// Takes the task's search out of its queue, cancelling it if it's the one running. The interface stays busy until the cancel or the
+	// search completes, the next search starts then.
+	static void Remove(UFindSessionsTask* task)
+	{
+		for (auto& pair : lanes)
+		{
+			auto& lane = pair.Value;
+			lane.queued.RemoveAll([task](const FQueued& queued) { return queued.task == task; });
+			if (!lane.busy || lane.running != task)
+				continue;
+
+			const auto key = pair.Key;
+			lane.running = nullptr;
+			lane.cancelling = true;
+			if (!lane.cancelled.IsValid())
+				lane.cancelled = lane.sessions->AddOnCancelFindSessionsCompleteDelegate_Handle(FOnCancelFindSessionsCompleteDelegate::CreateStatic(&FSessionSearchQueue::OnCancelled, key));
+
+			// May complete synchronously and start the next search, which can remove the lane.
+			const auto sessions = lane.sessions;
+			sessions->CancelFindSessions();
+			return;
+		}
+	}
 
-	if (!successful)
+	// Running searches aren't cancelled, their completion has nowhere to go anymore.
+	static void Reset()
 	{
-		UE_LOG(Sessions, Error, TEXT("Failed to create a session."));
-		callback.ExecuteIfBound(ESessionCreationResult::FailedToCreateSession);
-		return;
+		for (auto& pair : lanes)
+		{
+			auto& lane = pair.Value;
+			lane.sessions->ClearOnFindSessionsCompleteDelegate_Handle(lane.complete);
+			lane.sessions->ClearOnCancelFindSessionsCompleteDelegate_Handle(lane.cancelled);
+		}
+		lanes.Empty();
 	}
 
-	const auto delegate = FOnCreateSessionCompleteDelegate::CreateUObject(this, &UCreateSessionTask::OnStartOnlineGameComplete);
-	next = sessions->AddOnStartSessionCompleteDelegate_Handle(delegate);
+private:
+	struct FQueued
+	{
+		TWeakObjectPtr<UFindSessionsTask> task;
+		TSharedPtr<const FUniqueNetId> userId;
+	};
 
-	sessions->StartSession(name);
-}
+	struct FLane
+	{
+		IOnlineSessionPtr sessions;
+		TArray<FQueued> queued;
+		TWeakObjectPtr<UFindSessionsTask> running;
+		FDelegateHandle complete;
+		FDelegateHandle cancelled;
+
+		// The search of a task that was garbage collected or removed keeps the interface busy until it completes or, once cancelled, until the
+		// cancel does.
+		bool busy = false;
+		bool cancelling = false;
+	};
+
+	static inline TMap<IOnlineSession*, FLane> lanes;
+
+	// Completions may come synchronously from within FindSessions and start the next search themselves, so lanes are looked up again after each call.
+	static void StartNext(IOnlineSession* key)
+	{
+		for (auto lane = lanes.Find(key); lane != nullptr && !lane->busy; lane = lanes.Find(key))
+		{
+			if (lane->queued.Num() == 0)
+			{
+				lane->sessions->ClearOnFindSessionsCompleteDelegate_Handle(lane->complete);
+				lane->sessions->ClearOnCancelFindSessionsCompleteDelegate_Handle(lane->cancelled);
+				lanes.Remove(key);
+				return;
+			}
+
+			const auto next = lane->queued[0];
+			lane->queued.RemoveAt(0);
+			if (!next.task.IsValid())
+				continue;
+
+			if (!lane->complete.IsValid())
+				lane->complete = lane->sessions->AddOnFindSessionsCompleteDelegate_Handle(FOnFindSessionsCompleteDelegate::CreateStatic(&FSessionSearchQueue::OnComplete, key));
+			lane->busy = true;
+			lane->running = next.task;
+
+			const auto sessions = lane->sessions;
+			if (!sessions->FindSessions(*next.userId, next.task->search.ToSharedRef()))
+				Finish(key, next.task.Get(), false);
+		}
+	}
 
-void UCreateSessionTask::OnStartOnlineGameComplete(FName name, bool successful)
-{
-	auto sessions = GetSessionsInterface(callback, ESessionCreationResult::OnlineSubsystemNotFound, ESessionCreationResult::SessionsInterfaceNotFound);
-	if (!sessions.IsValid())
-		return;
+	static void OnComplete(bool successful, IOnlineSession* key)
+	{
+		const auto lane = lanes.Find(key);
+		if (lane == nullptr || !lane->busy)
+			return;
 
-	sessions->ClearOnStartSessionCompleteDelegate_Handle(next);
+		// A cancelled search completing late, after the next one started. The subsystems mark a search done before reporting it.
+		const auto running = lane->running.Get();
+		if (running != nullptr && running->search->SearchState == EOnlineAsyncTaskState::InProgress)
+			return;
 
-	if (!successful)
+		Finish(key, running, successful);
+	}
+
+	static void OnCancelled(bool successful, IOnlineSession* key)
 	{
-		sessions->DestroySession(name);
-		UE_LOG(Sessions, Error, TEXT("Failed to start session."));
-		callback.ExecuteIfBound(ESessionCreationResult::FailedToStartSession);
-		return;
+		if (const auto lane = lanes.Find(key); lane != nullptr && lane->busy && lane->cancelling)
+			Finish(key, nullptr, false);
 	}
 
-	callback.ExecuteIfBound(ESessionCreationResult::Success);
+	static void Finish(IOnlineSession* key, UFindSessionsTask* task, bool successful)
+	{
+		const auto lane = lanes.Find(key);
+		if (lane == nullptr || !lane->busy || lane->running.Get() != task)
+			return;
+
+		lane->busy = false;
+		lane->cancelling = false;
+		lane->running = nullptr;
+		if (task != nullptr)
+			task->OnFindSessionsComplete(successful);
+		StartNext(key);
+	}
+};
+
+void ShutdownSessionSearches()
+{
+	FSessionSearchQueue::Reset();
 }
 
 UFindSessionsTask::UFindSessionsTask()
@@ -154,6 +321,11 @@ UFindSessionsTask::UFindSessionsTask()
 }
 
 UFindSessionsTask* UFindSessionsTask::FindSessionsAsync(ULocalPlayer* player, bool lan, bool presence, int32 timeoutInSeconds, FFindSessionResultHandler callback_)
+{
+	return FindSessionsStreamingAsync(player, lan, presence, timeoutInSeconds, 1, 0, {}, callback_);
+}
+
+UFindSessionsTask* UFindSessionsTask::FindSessionsStreamingAsync(ULocalPlayer* player, bool lan, bool presence, int32 timeoutInSeconds, int32 maxResults, int32 pageSize_, FSessionBatchHandler onBatch_, FFindSessionResultHandler callback_, FName subsystem_)
 {
 	if (player == nullptr)
 	{
@@ -162,10 +334,18 @@ UFindSessionsTask* UFindSessionsTask::FindSessionsAsync(ULocalPlayer* player, bo
 		return nullptr;
 	}
 
+	auto task = CreateSearch(lan, presence, timeoutInSeconds, maxResults, pageSize_, onBatch_, callback_, subsystem_);
+	if (!task->FindSessionsAsync(player->GetPreferredUniqueNetId().GetUniqueNetId()))
+		return nullptr;
+	return task;
+}
+
+UFindSessionsTask* UFindSessionsTask::CreateSearch(bool lan, bool presence, int32 timeoutInSeconds, int32 maxResults, int32 pageSize_, FSessionBatchHandler onBatch_, FFindSessionResultHandler callback_, FName subsystem_)
+{
 	auto task = NewObject<UFindSessionsTask>();
 
 	task->search->bIsLanQuery = lan;
-	task->search->MaxSearchResults = 1;
+	task->search->MaxSearchResults = maxResults;
 	task->search->PingBucketSize = 50;
 	task->search->TimeoutInSeconds = timeoutInSeconds;
 
@@ -173,9 +353,9 @@ UFindSessionsTask* UFindSessionsTask::FindSessionsAsync(ULocalPlayer* player, bo
 		task->search->QuerySettings.Set(SEARCH_PRESENCE, presence, EOnlineComparisonOp::Equals);
 
 	task->callback = callback_;
-
-	if (!task->FindSessionsAsync(player->GetPreferredUniqueNetId().GetUniqueNetId()))
-		return nullptr;
+	task->onBatch = onBatch_;
+	task->pageSize = pageSize_ > 0 ? pageSize_ : MAX_int32;
+	task->subsystem = subsystem_;
 	return task;
 }
 
@@ -188,58 +368,110 @@ bool UFindSessionsTask::FindSessionsAsync(TSharedPtr<const FUniqueNetId> userId)
 		return false;
 	}
 
-	auto sessions = GetSessionsInterface(callback, EFindSessionsResult::OnlineSubsystemNotFound, EFindSessionsResult::SessionsInterfaceNotFound);
+	auto sessions = GetSessionsInterface(callback, EFindSessionsResult::OnlineSubsystemNotFound, EFindSessionsResult::SessionsInterfaceNotFound, subsystem);
 	if (!sessions.IsValid())
 		return false;
 
-	if (search->SearchState != EOnlineAsyncTaskState::Done && search->SearchState != EOnlineAsyncTaskState::NotStarted)
+	FSessionSearchQueue::Remove(this);
+
+	// A cancelled search may still be written to by the subsystem, so the new one gets its own object. Session ids index its results, which start over.
+	search = MakeShared<FOnlineSessionSearch>(*search);
+	search->SearchResults.Reset();
+	search->SearchState = EOnlineAsyncTaskState::NotStarted;
+	results.Reset();
+	details.Reset();
+
+	// Subsystems append to the search results as replies come in but only report once the search is over, so streaming polls them every frame.
+	// Registered before starting the search, which may complete right away.
+	if (onBatch.IsBound() && !poll.IsValid())
 	{
-		sessions->CancelFindSessions();
+		poll = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([task = TWeakObjectPtr<UFindSessionsTask>(this)](float)
+			{
+				if (!task.IsValid())
+					return false;
+				task->DeliverNewResults();
+				return true;
+			}));
 	}
 
-	const auto delegate = FOnFindSessionsCompleteDelegate::CreateUObject(this, &UFindSessionsTask::OnFindSessionsComplete);
-	next = sessions->AddOnFindSessionsCompleteDelegate_Handle(delegate);
-
-	return sessions->FindSessions(*userId, search.ToSharedRef());
+	// Failing to start is reported through OnFindSessionsComplete like a failed search.
+	FSessionSearchQueue::Enqueue(sessions, this, userId);
+	return true;
 }
 
-void UFindSessionsTask::JoinSessionAsync(UObject* worldContext, ULocalPlayer* player, int32 sessionId, FJoinSessionResultHandler callback_)
+UJoinSessionTask* UFindSessionsTask::JoinSessionAsync(UObject* worldContext, ULocalPlayer* player, int32 sessionId, FJoinSessionResultHandler callback_)
 {
 	if (player == nullptr)
 	{
 		UE_LOG(Sessions, Error, TEXT("Player is invalid."));
 		callback_.ExecuteIfBound(EJoinSessionResult::InvalidPlayer);
-		return;
+		return nullptr;
+	}
+
+	if (!search->SearchResults.IsValidIndex(sessionId))
+	{
+		UE_LOG(Sessions, Error, TEXT("Session %d isn't among the search results."), sessionId);
+		callback_.ExecuteIfBound(EJoinSessionResult::SessionDoesNotExist);
+		return nullptr;
 	}
 
 	auto task = NewObject<UJoinSessionTask>(this);
 	task->world = worldContext->GetWorld();
 	task->callback = callback_;
+	task->subsystem = subsystem;
+
+	// Kept as a fallback, some subsystems don't resolve the joined session.
+	const auto onlineSubsystem = IOnlineSubsystem::Get(subsystem);
+	const auto sessions = onlineSubsystem ? onlineSubsystem->GetSessionInterface() : nullptr;
+	if (sessions.IsValid() && !sessions->GetResolvedConnectString(search->SearchResults[sessionId], NAME_GamePort, task->connectString))
+		task->connectString.Reset();
 	task->JoinSessionAsync(player->GetPreferredUniqueNetId().GetUniqueNetId(), GameSessionName, search->SearchResults[sessionId]);
+	return task;
 }
 
 TArray<USessionDetails*> UFindSessionsTask::GetSessions()
 {
-	TArray<USessionDetails*> ret;
-
-	for (auto i : Range::Indexes<int32>(search->SearchResults))
+	for (auto i = details.Num(); i < results.Num(); ++i)
 	{
-		auto session = NewObject<USessionDetails>();
+		auto session = NewObject<USessionDetails>(this);
 		session->sessions = this;
-		session->id = i;
-		ret.Add(session);
+		session->result = results[i];
+		details.Add(session);
 	}
 
+	return details;
+}
+
+TArray<USessionDetails*> UFindSessionsTask::MergeSessions(const TArray<UFindSessionsTask*>& tasks)
+{
+	auto ret = TArray<USessionDetails*>{};
+	auto indices = TMap<FString, int32>{};
+	for (const auto task : tasks)
+	{
+		if (task == nullptr)
+			continue;
+
+		for (const auto session : task->GetSessions())
+		{
+			const auto& result = session->result;
+			if (const auto index = indices.Find(result.sessionId))
+			{
+				auto& kept = ret[*index];
+				if (result.ping < kept->result.ping)
+					kept = session;
+				continue;
+			}
+
+			indices.Add(result.sessionId, ret.Num());
+			ret.Add(session);
+		}
+	}
 	return ret;
 }
 
 void UFindSessionsTask::OnFindSessionsComplete(bool successful)
 {
-	auto sessions = GetSessionsInterface(callback, EFindSessionsResult::OnlineSubsystemNotFound, EFindSessionsResult::SessionsInterfaceNotFound);
-	if (!sessions.IsValid())
-		return;
-
-	sessions->ClearOnFindSessionsCompleteDelegate_Handle(next);
+	StopPolling();
 
 	if (!successful)
 	{
@@ -248,9 +480,43 @@ void UFindSessionsTask::OnFindSessionsComplete(bool successful)
 		return;
 	}
 
+	DeliverNewResults();
 	callback.ExecuteIfBound(EFindSessionsResult::Success);
 }
 
+void UFindSessionsTask::DeliverNewResults()
+{
+	const auto& found = search->SearchResults;
+
+	// Some subsystems replace the list when the search completes, then its ids start over. The new list may be as long or longer and ordered
+	// differently, so the sessions already delivered are compared too.
+	const auto replaced = found.Num() < results.Num()
+		|| results.ContainsByPredicate([&](const FSessionResult& delivered) { return found[delivered.id].GetSessionIdStr() != delivered.sessionId; });
+	if (replaced)
+	{
+		results.Reset();
+		details.Reset();
+	}
+
+	const auto first = results.Num();
+	for (auto i = first; i < found.Num(); ++i)
+		results.Add(MakeSessionResult(i, found[i]));
+
+	for (auto from = first; from < results.Num() && onBatch.IsBound();)
+	{
+		const auto num = FMath::Min(pageSize, results.Num() - from);
+		onBatch.Execute(TArray<FSessionResult>(results.GetData() + from, num));
+		from += num;
+	}
+}
+
+void UFindSessionsTask::StopPolling()
+{
+	if (poll.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(poll);
+	poll.Reset();
+}
+
 void UJoinSessionTask::JoinSessionAsync(TSharedPtr<const FUniqueNetId> userId, FName sessionName, const FOnlineSessionSearchResult& searchResult)
 {
 	if (!userId.IsValid())
@@ -260,19 +526,26 @@ void UJoinSessionTask::JoinSessionAsync(TSharedPtr<const FUniqueNetId> userId, F
 		return;
 	}
 
-	auto sessions = GetSessionsInterface(callback, EJoinSessionResult::OnlineSubsystemNotFound, EJoinSessionResult::SessionsInterfaceNotFound);
+	auto sessions = GetSessionsInterface(callback, EJoinSessionResult::OnlineSubsystemNotFound, EJoinSessionResult::SessionsInterfaceNotFound, subsystem);
 	if (!sessions.IsValid())
 		return;
 
+	// Found now rather than once joined, the join completes asynchronously for most subsystems anyway.
+	const auto start = FPlatformTime::Cycles64();
+	controller = PlayerControllerRange(world).GetFirstLocal();
+	controllerCycles = FPlatformTime::Cycles64() - start;
+
 	const auto delegate = FOnJoinSessionCompleteDelegate::CreateUObject(this, &UJoinSessionTask::OnJoinSessionComplete);
 	next = sessions->AddOnJoinSessionCompleteDelegate_Handle(delegate);
 
+	requested = FPlatformTime::Cycles64();
 	sessions->JoinSession(*userId, sessionName, searchResult);
 }
 
 void UJoinSessionTask::OnJoinSessionComplete(FName sessionName, EOnJoinSessionCompleteResult::Type result)
 {
-	auto sessions = GetSessionsInterface(callback, EJoinSessionResult::OnlineSubsystemNotFound, EJoinSessionResult::SessionsInterfaceNotFound);
+	const auto joined = FPlatformTime::Cycles64();
+	auto sessions = GetSessionsInterface(callback, EJoinSessionResult::OnlineSubsystemNotFound, EJoinSessionResult::SessionsInterfaceNotFound, subsystem);
 	if (!sessions.IsValid())
 		return;
 
@@ -304,46 +577,70 @@ void UJoinSessionTask::OnJoinSessionComplete(FName sessionName, EOnJoinSessionCo
 		break;
 	}
 
-	const auto controllers = PlayerControllerRange(world);
-	if (controllers.begin() == controllers.end())
+	// What was prepared during the join only needs looking up again if it went stale meanwhile.
+	auto start = FPlatformTime::Cycles64();
+	const auto prefetchedController = controller.Get();
+	const auto traveling = prefetchedController != nullptr ? prefetchedController : PlayerControllerRange(world).GetFirstLocal();
+	const auto controllerLookup = FPlatformTime::Cycles64() - start;
+	if (traveling == nullptr)
 	{
 		UE_LOG(Sessions, Error, TEXT("Can't find controller to travel."));
 		callback.ExecuteIfBound(EJoinSessionResult::FailedToFindController);
 		return;
 	}
 
-	const auto controller = *PlayerControllerRange(world).begin();
-	if (!controller.IsValid())
+	// The joined session is authoritative, the host may have handed out another address (e.g. a relay) than the search result had.
+	start = FPlatformTime::Cycles64();
+	auto travelURL = FString{};
+	const auto resolved = sessions->GetResolvedConnectString(sessionName, travelURL);
+	const auto resolve = FPlatformTime::Cycles64() - start;
+	if (!resolved)
 	{
-		UE_LOG(Sessions, Error, TEXT("Can't find controller to travel."));
-		callback.ExecuteIfBound(EJoinSessionResult::FailedToFindController);
-		return;
+		if (connectString.IsEmpty())
+		{
+			UE_LOG(Sessions, Error, TEXT("Can't travel."));
+			callback.ExecuteIfBound(EJoinSessionResult::FailedToTravel);
+			return;
+		}
+
+		UE_LOG(Sessions, Log, TEXT("The joined session didn't resolve, traveling to the address of its search result."));
+		travelURL = connectString;
+		++joinLatency.resolveFallbacks;
 	}
-
-	FString travelURL;
-
-	if (!sessions->GetResolvedConnectString(sessionName, travelURL))
+	else if (!connectString.IsEmpty() && connectString != travelURL)
 	{
-		UE_LOG(Sessions, Error, TEXT("Can't travel."));
-		callback.ExecuteIfBound(EJoinSessionResult::FailedToTravel);
-		return;
+		UE_LOG(Sessions, Log, TEXT("The joined session resolved to %s instead of %s."), *travelURL, *connectString);
+		++joinLatency.searchResultMismatches;
 	}
 
 	UE_LOG(Sessions, Warning, TEXT("%s."), *travelURL);
-	controller->ClientTravel(travelURL, ETravelType::TRAVEL_Absolute);
+	start = FPlatformTime::Cycles64();
+	traveling->ClientTravel(travelURL, ETravelType::TRAVEL_Absolute);
+	const auto travel = FPlatformTime::Cycles64() - start;
+
+	++joinLatency.joins;
+	joinLatency.joinMs += FPlatformTime::ToMilliseconds64(joined - requested);
+	joinLatency.controllerMs += FPlatformTime::ToMilliseconds64(controllerLookup);
+	joinLatency.resolveMs += FPlatformTime::ToMilliseconds64(resolve);
+	joinLatency.travelMs += FPlatformTime::ToMilliseconds64(travel);
+	if (prefetchedController != nullptr)
+		joinLatency.controllerSavedMs += FPlatformTime::ToMilliseconds64(controllerCycles);
+	UE_LOG(Sessions, Log, TEXT("Joined in %.2f ms, then traveled after %.3f ms."), FPlatformTime::ToMilliseconds64(joined - requested), FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - joined));
+
 	callback.ExecuteIfBound(EJoinSessionResult::Success);
 }
 
-void UDestroySessionTask::DestroySessionAsync(FName name, FDestroySessionResultHandler callback_)
+void UDestroySessionTask::DestroySessionAsync(FName name, FDestroySessionResultHandler callback_, FName subsystem_)
 {
 	auto task = NewObject<UDestroySessionTask>();
 	task->callback = callback_;
+	task->subsystem = subsystem_;
 	task->DestroySessionAsync(name);
 }
 
 void UDestroySessionTask::DestroySessionAsync(FName name)
 {
-	auto sessions = GetSessionsInterface(callback, EDestroySessionResult::OnlineSubsystemNotFound, EDestroySessionResult::SessionsInterfaceNotFound);
+	auto sessions = GetSessionsInterface(callback, EDestroySessionResult::OnlineSubsystemNotFound, EDestroySessionResult::SessionsInterfaceNotFound, subsystem);
 	if (!sessions.IsValid())
 		return;
 
@@ -355,7 +652,7 @@ void UDestroySessionTask::DestroySessionAsync(FName name)
 
 void UDestroySessionTask::OnDestroySessionComplete(FName name, bool successful)
 {
-	auto sessions = GetSessionsInterface(callback, EDestroySessionResult::OnlineSubsystemNotFound, EDestroySessionResult::SessionsInterfaceNotFound);
+	auto sessions = GetSessionsInterface(callback, EDestroySessionResult::OnlineSubsystemNotFound, EDestroySessionResult::SessionsInterfaceNotFound, subsystem);
 	if (!sessions.IsValid())
 		return;
 
@@ -0,0 +1,91 @@
+#include <GPUtils/SpatialIndex.h>
+
+#include <Components/SceneComponent.h>
+#include <Engine/Level.h>
+#include <EngineUtils.h>
+#include <GameFramework/Actor.h>
+
+void USpatialIndexSubsystem::Initialize(FSubsystemCollectionBase& collection)
+{
+	Super::Initialize(collection);
+
+	actorSpawned = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &USpatialIndexSubsystem::OnActorSpawned));
+	levelAdded = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USpatialIndexSubsystem::OnLevelAdded);
+}
+
+void USpatialIndexSubsystem::Deinitialize()
+{
+	if (const auto world = GetWorld())
+		world->RemoveOnActorSpawnedHandler(actorSpawned);
+	FWorldDelegates::LevelAddedToWorld.Remove(levelAdded);
+	grids.Empty();
+
+	Super::Deinitialize();
+}
+
+void USpatialIndexSubsystem::EnableIndex(UClass* actorClass, float cellSize)
+{
+	check(actorClass && actorClass->IsChildOf<AActor>());
+	if (grids.Contains(actorClass))
+		return;
+
+	auto& grid = *grids.Add(actorClass, MakeUnique<Grid>(cellSize));
+	for (auto it = TActorIterator<AActor>{ GetWorld(), actorClass }; it; ++it)
+		Add(*it, grid);
+}
+
+const USpatialIndexSubsystem::Grid* USpatialIndexSubsystem::Find(UClass* actorClass) const
+{
+	const auto grid = grids.Find(actorClass);
+	return grid ? grid->Get() : nullptr;
+}
+
+void USpatialIndexSubsystem::Add(AActor* actor, Grid& grid)
+{
+	if (!IsValid(actor))
+		return;
+
+	grid.Add(actor, actor->GetActorLocation());
+	actor->OnEndPlay.AddUniqueDynamic(this, &USpatialIndexSubsystem::OnActorEndPlay);
+
+	const auto root = actor->GetRootComponent();
+	if (root && !root->TransformUpdated.IsBoundToObject(this))
+		root->TransformUpdated.AddUObject(this, &USpatialIndexSubsystem::OnTransformUpdated);
+}
+
+void USpatialIndexSubsystem::OnActorSpawned(AActor* actor)
+{
+	for (auto& pair : grids)
+		if (actor->IsA(pair.Key))
+			Add(actor, *pair.Value);
+}
+
+void USpatialIndexSubsystem::OnTransformUpdated(USceneComponent* component, EUpdateTransformFlags flags, ETeleportType teleport)
+{
+	const auto actor = component->GetOwner();
+	if (actor == nullptr)
+		return;
+
+	const auto location = component->GetComponentLocation();
+	for (auto& pair : grids)
+		pair.Value->Move(actor, location);
+}
+
+void USpatialIndexSubsystem::OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason)
+{
+	for (auto& pair : grids)
+		pair.Value->Remove(actor);
+
+	if (const auto root = actor->GetRootComponent())
+		root->TransformUpdated.RemoveAll(this);
+}
+
+void USpatialIndexSubsystem::OnLevelAdded(ULevel* level, UWorld* world)
+{
+	if (world != GetWorld() || level == nullptr)
+		return;
+
+	for (const auto actor : level->Actors)
+		if (actor)
+			OnActorSpawned(actor);
+}
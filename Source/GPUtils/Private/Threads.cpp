@@ -1,11 +1,241 @@
 #include <GPUtils/Threads.h>
 
-#include <Async/Async.h>
+#include <GPUtils/HopStats.h>
+
+#include <Async/TaskGraphInterfaces.h>
+#include <Containers/Queue.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+
+#include <atomic>
+
+static TAutoConsoleVariable<int32> CVarDrainPoint(
+	TEXT("GPUtils.GameThreadQueue.DrainPoint"),
+	static_cast<int32>(EGameThreadDrainPoint::EngineTick),
+	TEXT("Where ExecuteInGameThread delegates run: 0 - engine tick, 1 - world tick start, 2 - after the actor tick. The task graph also runs them when it processes game thread tasks first, e.g. while the game thread waits."));
+
+static TAutoConsoleVariable<float> CVarMaxMsPerDrain(
+	TEXT("GPUtils.GameThreadQueue.MaxMsPerDrain"),
+	0.f,
+	TEXT("Time budget of one drain of the game thread queue in milliseconds, the rest waits for the next one. 0 - unlimited."));
+
+static TAutoConsoleVariable<float> CVarBudgetMs(
+	TEXT("GPUtils.GameThreadBudget.Ms"),
+	2.f,
+	TEXT("Game thread time per frame for ExecuteInGameThreadBudgeted work in milliseconds, at least one step runs per frame. 0 - unlimited, every pending step runs once per frame."));
+
+namespace
+{
+	struct FQueuedDelegate
+	{
+		TUniqueFunction<void()> delegate;
+		uint64 enqueued;
+	};
+
+	TQueue<FQueuedDelegate, EQueueMode::Mpsc> queue;
+	std::atomic<int32> pending{ 0 };
+
+	// Whether a task graph task that drains the queue is on its way, so that there's at most one.
+	std::atomic<bool> wakePosted{ false };
+
+	// Written by the game thread only, atomics so that stats can be read from anywhere.
+	std::atomic<uint64> executed{ 0 };
+	std::atomic<uint64> latencyCycles{ 0 };
+	std::atomic<uint64> maxLatencyCycles{ 0 };
+
+	// Budgeted steps per priority, game thread only. The cursor is where the next frame continues, so every step of a priority gets its turn.
+	constexpr auto NumPriorities = static_cast<int32>(EJobPriority::Num);
+	TArray<TUniqueFunction<bool()>> steps[NumPriorities];
+	int32 cursors[NumPriorities] = {};
+	uint64 budgetDeadline = 0;
+
+	uint64 budgetFrames = 0;
+	uint64 overBudgetFrames = 0;
+	uint64 budgetCycles = 0;
+	uint64 maxBudgetCycles = 0;
+	uint64 lastBudgetCycles = 0;
+
+	uint64 MillisecondsToCycles(double ms)
+	{
+		return static_cast<uint64>(ms / 1000.0 / FPlatformTime::GetSecondsPerCycle64());
+	}
+
+	// Runs queued delegates until the queue is empty or the deadline passed, at least one.
+	void Drain(uint64 deadline)
+	{
+		auto item = FQueuedDelegate{};
+		while (queue.Dequeue(item))
+		{
+			const auto now = FPlatformTime::Cycles64();
+			const auto latency = now - item.enqueued;
+			executed.fetch_add(1, std::memory_order_relaxed);
+			latencyCycles.fetch_add(latency, std::memory_order_relaxed);
+			if (latency > maxLatencyCycles.load(std::memory_order_relaxed))
+				maxLatencyCycles.store(latency, std::memory_order_relaxed);
+			pending.fetch_sub(1, std::memory_order_relaxed);
+
+			{
+				GPUTILS_HOP_SCOPE(GPUTILS_HOP_TAG("GameThreadQueue"), item.enqueued);
+				item.delegate();
+			}
+
+			if (FPlatformTime::Cycles64() >= deadline)
+				break;
+		}
+	}
+
+	void PostWakeTask()
+	{
+		if (wakePosted.exchange(true))
+			return;
+
+		FFunctionGraphTask::CreateAndDispatchWhenReady([]
+			{
+				// Cleared first: delegates queued from now on either are drained below or post the next task.
+				wakePosted = false;
+				DrainGameThreadQueue(EGameThreadDrainPoint::EngineTick, true);
+
+				// Left over by MaxMsPerDrain, they'd wait for a drain point that may not come while the game thread is blocked.
+				if (pending.load() > 0)
+					PostWakeTask();
+			}, TStatId{}, nullptr, ENamedThreads::GameThread);
+	}
+}
 
 void ExecuteInGameThread(TUniqueFunction<void()>&& delegate)
 {
 	if (IsInGameThread())
+	{
 		delegate();
-	else
-		AsyncTask(ENamedThreads::GameThread, MoveTemp(delegate));
+		return;
+	}
+
+	const auto wasEmpty = pending.fetch_add(1) == 0;
+	queue.Enqueue({ MoveTemp(delegate), FPlatformTime::Cycles64(), });
+	if (wasEmpty)
+		PostWakeTask();
+}
+
+void DrainGameThreadQueue(EGameThreadDrainPoint point, bool force)
+{
+	check(IsInGameThread());
+	if (!force && static_cast<int32>(point) != CVarDrainPoint.GetValueOnGameThread())
+		return;
+
+	const auto budgetMs = CVarMaxMsPerDrain.GetValueOnGameThread();
+	Drain(budgetMs > 0 ? FPlatformTime::Cycles64() + MillisecondsToCycles(budgetMs) : MAX_uint64);
+}
+
+void FlushGameThreadQueue()
+{
+	check(IsInGameThread());
+
+	// pending counts a delegate before it's in the queue, so a producer between the two is waited for.
+	while (pending.load() > 0)
+		Drain(MAX_uint64);
+}
+
+FGameThreadQueueStats GetGameThreadQueueStats(bool reset)
+{
+	const auto count = reset ? executed.exchange(0) : executed.load();
+	const auto total = reset ? latencyCycles.exchange(0) : latencyCycles.load();
+	const auto max = reset ? maxLatencyCycles.exchange(0) : maxLatencyCycles.load();
+
+	auto ret = FGameThreadQueueStats{};
+	ret.executed = count;
+	ret.pending = pending.load();
+	ret.averageLatencyMs = count > 0 ? FPlatformTime::ToMilliseconds64(total) / count : 0;
+	ret.maxLatencyMs = FPlatformTime::ToMilliseconds64(max);
+	return ret;
+}
+
+void ExecuteInGameThreadBudgeted(TUniqueFunction<bool()>&& step, EJobPriority priority)
+{
+	if (!IsInGameThread())
+	{
+		ExecuteInGameThread([step = MoveTemp(step), priority]() mutable { ExecuteInGameThreadBudgeted(MoveTemp(step), priority); });
+		return;
+	}
+
+	steps[static_cast<int32>(priority)].Add(MoveTemp(step));
+}
+
+void ExecuteInGameThreadChunked(int32 num, TUniqueFunction<void(int32)>&& body, EJobPriority priority)
+{
+	if (num <= 0)
+		return;
+
+	ExecuteInGameThreadBudgeted([num, body = MoveTemp(body), i = 0]() mutable
+		{
+			body(i);
+			return ++i < num;
+		}, priority);
+}
+
+bool IsGameThreadBudgetExhausted()
+{
+	return FPlatformTime::Cycles64() >= budgetDeadline;
+}
+
+void RunGameThreadBudget()
+{
+	check(IsInGameThread());
+
+	// Unlimited is one turn per step rather than until all are done, so that steps waiting on something else can't hang the frame.
+	const auto start = FPlatformTime::Cycles64();
+	const auto budgetMs = CVarBudgetMs.GetValueOnGameThread();
+	const auto unlimited = budgetMs <= 0;
+	const auto budget = unlimited ? 0 : MillisecondsToCycles(budgetMs);
+	budgetDeadline = unlimited ? MAX_uint64 : start + budget;
+
+	// The budget is checked after running a step like the queue's drain deadline, so a budget shorter than any step still makes progress.
+	auto ran = false;
+	for (auto priority = 0; priority < NumPriorities && (!ran || !IsGameThreadBudgetExhausted()); ++priority)
+	{
+		auto& queued = steps[priority];
+		auto& cursor = cursors[priority];
+		for (auto turns = unlimited ? queued.Num() : MAX_int32; queued.Num() > 0 && turns > 0 && (!ran || !IsGameThreadBudgetExhausted()); --turns)
+		{
+			if (cursor >= queued.Num())
+				cursor = 0;
+
+			// Moved out while it runs, the step may add more steps and reallocate the array.
+			auto step = MoveTemp(queued[cursor]);
+			ran = true;
+			if (step())
+				queued[cursor++] = MoveTemp(step);
+			else
+				queued.RemoveAt(cursor);
+		}
+	}
+	budgetDeadline = 0;
+
+	if (!ran)
+		return;
+
+	const auto used = FPlatformTime::Cycles64() - start;
+	++budgetFrames;
+	overBudgetFrames += !unlimited && used > budget ? 1 : 0;
+	budgetCycles += used;
+	maxBudgetCycles = FMath::Max(maxBudgetCycles, used);
+	lastBudgetCycles = used;
+}
+
+FGameThreadBudgetStats GetGameThreadBudgetStats(bool reset)
+{
+	check(IsInGameThread());
+
+	auto ret = FGameThreadBudgetStats{};
+	for (const auto& queued : steps)
+		ret.pending += queued.Num();
+	ret.frames = budgetFrames;
+	ret.overBudgetFrames = overBudgetFrames;
+	ret.budgetMs = CVarBudgetMs.GetValueOnGameThread();
+	ret.lastFrameMs = FPlatformTime::ToMilliseconds64(lastBudgetCycles);
+	ret.averageFrameMs = budgetFrames > 0 ? FPlatformTime::ToMilliseconds64(budgetCycles) / budgetFrames : 0;
+	ret.maxFrameMs = FPlatformTime::ToMilliseconds64(maxBudgetCycles);
+
+	if (reset)
+		budgetFrames = overBudgetFrames = budgetCycles = maxBudgetCycles = lastBudgetCycles = 0;
+	return ret;
 }
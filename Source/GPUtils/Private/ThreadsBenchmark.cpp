@@ -0,0 +1,197 @@
+#include <GPUtils/Jobs.h>
+#include <GPUtils/Threads.h>
+
+#include <Async/Async.h>
+#include <Async/TaskGraphInterfaces.h>
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
+#include <atomic>
+
+#if !UE_BUILD_SHIPPING
+
+// Threading benchmarks, reported as JSON:
+// GPUtils.BenchmarkGameThreadQueue [delegates] [producers] [path] - ExecuteInGameThread against posting a task graph task per delegate.
+// GPUtils.BenchmarkJobs [leaves] [path] - the job scheduler against serial execution and the thread pool, for several job sizes and worker counts.
+namespace
+{
+    void Save(const FString& json, const TArray<FString>& args, int32 pathIndex)
+    {
+        if (args.Num() <= pathIndex)
+            return;
+
+        const auto path = FPaths::IsRelative(args[pathIndex]) ? FPaths::Combine(FPaths::ProjectDir(), args[pathIndex]) : args[pathIndex];
+        if (!FFileHelper::SaveStringToFile(json, *path))
+            UE_LOG(LogTemp, Error, TEXT("Failed to write the benchmark to %s"), *path);
+    }
+
+    struct Result
+    {
+        double produceNs;
+        double consumeNs;
+    };
+
+    // Posts `count` delegates from `producers` pool threads with `post`, then runs them on the game thread with `consume`. Times are per delegate.
+    template <class TPost, class TConsume>
+    Result Measure(int32 count, int32 producers, const TPost& post, const TConsume& consume)
+    {
+        std::atomic<int32> ran{ 0 };
+        const auto perProducer = count / producers;
+
+        const auto produceStart = FPlatformTime::Seconds();
+        auto futures = TArray<TFuture<void>>{};
+        for (auto i = 0; i < producers; ++i)
+            futures.Add(Async(EAsyncExecution::ThreadPool, [&] { for (auto j = 0; j < perProducer; ++j) post([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }); }));
+        for (auto& future : futures)
+            future.Wait();
+        const auto produced = FPlatformTime::Seconds() - produceStart;
+
+        const auto consumeStart = FPlatformTime::Seconds();
+        while (ran.load() < perProducer * producers)
+            consume();
+        const auto consumed = FPlatformTime::Seconds() - consumeStart;
+
+        const auto total = FMath::Max(perProducer * producers, 1);
+        return { produced * 1e9 / total, consumed * 1e9 / total, };
+    }
+
+    void BenchmarkGameThreadQueue(const TArray<FString>& args)
+    {
+        const auto count = args.Num() > 0 ? FCString::Atoi(*args[0]) : 100000;
+        const auto producers = FMath::Max(args.Num() > 1 ? FCString::Atoi(*args[1]) : 4, 1);
+
+        GetGameThreadQueueStats(true);
+        const auto queue = Measure(count, producers,
+            [](TUniqueFunction<void()>&& delegate) { ExecuteInGameThread(MoveTemp(delegate)); },
+            [] { DrainGameThreadQueue(EGameThreadDrainPoint::EngineTick, true); });
+        const auto stats = GetGameThreadQueueStats(true);
+
+        const auto taskGraph = Measure(count, producers,
+            [](TUniqueFunction<void()>&& delegate) { AsyncTask(ENamedThreads::GameThread, MoveTemp(delegate)); },
+            [] { FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread); });
+
+        const auto json = FString::Printf(
+            TEXT("{\n  \"delegates\": %d,\n  \"producers\": %d,\n")
+            TEXT("  \"queue\": { \"produceNsPerDelegate\": %.2f, \"consumeNsPerDelegate\": %.2f, \"averageLatencyMs\": %.4f, \"maxLatencyMs\": %.4f },\n")
+            TEXT("  \"taskGraph\": { \"produceNsPerDelegate\": %.2f, \"consumeNsPerDelegate\": %.2f }\n}\n"),
+            count, producers, queue.produceNs, queue.consumeNs, stats.averageLatencyMs, stats.maxLatencyMs, taskGraph.produceNs, taskGraph.consumeNs);
+        UE_LOG(LogTemp, Display, TEXT("Game thread queue benchmark:\n%s"), *json);
+        Save(json, args, 2);
+    }
+
+    // Stand-in for a decode or compress step, `iterations` long.
+    uint32 Work(int32 iterations)
+    {
+        auto ret = uint32(2166136261);
+        for (auto i = 0; i < iterations; ++i)
+            ret = (ret ^ static_cast<uint32>(i)) * 16777619;
+        return ret;
+    }
+
+    double Milliseconds(const TFunctionRef<void()>& run)
+    {
+        const auto start = FPlatformTime::Seconds();
+        run();
+        return (FPlatformTime::Seconds() - start) * 1000;
+    }
+
+    // One root fanning out into branches of 64 leaves, like a decode fanning out into mips.
+    double FanOut(int32 leaves, int32 iterations, std::atomic<uint32>& sink)
+    {
+        return Milliseconds([&]
+            {
+                const auto root = LaunchJob([&]
+                    {
+                        for (auto branch = 0; branch < leaves; branch += 64)
+                            LaunchJob([&, branch]
+                                {
+                                    for (auto i = branch; i < FMath::Min(branch + 64, leaves); ++i)
+                                        LaunchJob([&] { sink.fetch_add(Work(iterations), std::memory_order_relaxed); }, EJobPriority::Normal, GetCurrentJob());
+                                }, EJobPriority::Normal, GetCurrentJob());
+                    });
+                WaitForJob(root);
+            });
+    }
+
+    void BenchmarkJobs(const TArray<FString>& args)
+    {
+        const auto leaves = FMath::Max(args.Num() > 0 ? FCString::Atoi(*args[0]) : 4096, 1);
+        std::atomic<uint32> sink{ 0 };
+
+        auto cases = FString{};
+        for (const auto iterations : { 1000, 10000, 100000, })
+        {
+            const auto serialMs = Milliseconds([&]
+                {
+                    for (auto i = 0; i < leaves; ++i)
+                        sink.fetch_add(Work(iterations), std::memory_order_relaxed);
+                });
+
+            GetJobStats(true);
+            const auto jobsMs = FanOut(leaves, iterations, sink);
+            const auto stats = GetJobStats(true);
+
+            const auto poolMs = Milliseconds([&]
+                {
+                    auto futures = TArray<TFuture<void>>{};
+                    futures.Reserve(leaves);
+                    for (auto i = 0; i < leaves; ++i)
+                        futures.Add(Async(EAsyncExecution::ThreadPool, [&] { sink.fetch_add(Work(iterations), std::memory_order_relaxed); }));
+                    for (auto& future : futures)
+                        future.Wait();
+                });
+
+            cases += FString::Printf(
+                TEXT("%s    { \"iterations\": %d, \"serialMs\": %.3f, \"jobsMs\": %.3f, \"threadPoolMs\": %.3f, \"speedup\": %.2f, \"steals\": %llu, \"idleMs\": %.3f }"),
+                cases.IsEmpty() ? TEXT("") : TEXT(",\n"), iterations, serialMs, jobsMs, poolMs, serialMs / FMath::Max(jobsMs, 1e-6), stats.steals, stats.idleMs);
+        }
+
+        // Scaling of the middle job size with the number of workers, doubling up to all of them. The calling thread helps in every case.
+        const auto workers = GetJobStats().workers;
+        auto scaling = FString{};
+        for (auto num = 1; num <= workers; num = num < workers ? FMath::Min(num * 2, workers) : workers + 1)
+        {
+            SetJobWorkerLimit(num);
+            GetJobStats(true);
+            const auto jobsMs = FanOut(leaves, 10000, sink);
+            const auto stats = GetJobStats(true);
+            scaling += FString::Printf(
+                TEXT("%s    { \"workers\": %d, \"jobsMs\": %.3f, \"steals\": %llu, \"idleMs\": %.3f }"),
+                scaling.IsEmpty() ? TEXT("") : TEXT(",\n"), num, jobsMs, stats.steals, stats.idleMs);
+        }
+        SetJobWorkerLimit(0);
+
+        // Time to start a high priority job behind a backlog of low priority ones, e.g. a visible thumbnail behind prefetching.
+        std::atomic<double> started{ 0 };
+        const auto backlog = LaunchJob([&]
+            {
+                for (auto i = 0; i < leaves; ++i)
+                    LaunchJob([&] { sink.fetch_add(Work(10000), std::memory_order_relaxed); }, EJobPriority::Low, GetCurrentJob());
+            }, EJobPriority::Low);
+        const auto launched = FPlatformTime::Seconds();
+        WaitForJob(LaunchJob([&] { started = FPlatformTime::Seconds(); }, EJobPriority::High));
+        const auto highPriorityLatencyMs = (started - launched) * 1000;
+        WaitForJob(backlog);
+
+        const auto json = FString::Printf(
+            TEXT("{\n  \"leaves\": %d,\n  \"workers\": %d,\n  \"highPriorityLatencyMs\": %.3f,\n  \"checksum\": %u,\n  \"cases\": [\n%s\n  ],\n  \"scaling\": [\n%s\n  ]\n}\n"),
+            leaves, workers, highPriorityLatencyMs, sink.load(), *cases, *scaling);
+        UE_LOG(LogTemp, Display, TEXT("Job scheduler benchmark:\n%s"), *json);
+        Save(json, args, 1);
+    }
+
+    FAutoConsoleCommand BenchmarkGameThreadQueueCommand(
+        TEXT("GPUtils.BenchmarkGameThreadQueue"),
+        TEXT("Compares ExecuteInGameThread with a task graph task per delegate. Arguments: delegates, producer threads, path of the JSON report."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGameThreadQueue));
+
+    FAutoConsoleCommand BenchmarkJobsCommand(
+        TEXT("GPUtils.BenchmarkJobs"),
+        TEXT("Compares the job scheduler with serial execution and the thread pool for several job sizes and worker counts. Arguments: leaf jobs, path of the JSON report."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkJobs));
+}
+
+#endif
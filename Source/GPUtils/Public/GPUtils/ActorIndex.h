@@ -0,0 +1,112 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Engine/EngineBaseTypes.h>
+#include <Engine/EngineTypes.h>
+#include <Subsystems/WorldSubsystem.h>
+
+#include "ActorIndex.generated.h"
+
+class AActor;
+class ULevel;
+
+USTRUCT()
+struct FActorIndexBucket
+{
+	GENERATED_BODY()
+
+	// Removed actors are nulled out and compacted away after the actor tick, so removing never reorders an array someone may be iterating.
+	// So are the ones that never ended play (e.g. destroyed before BeginPlay), once the garbage collector has nulled them.
+	UPROPERTY()
+	TArray<AActor*> actors;
+
+	TMap<AActor*, int32> slots;
+	int32 removed = 0;
+
+	// One bitset per defined flag, bit i belongs to actors[i]. The transposed layout lets a query combine 32 actors per word and jump to matches.
+	// present has the bits of removed actors cleared, so flag queries don't need to look at the actors.
+	TArray<TBitArray<>> flags;
+	TBitArray<> present;
+};
+
+// Flags are told apart by kind and name, so that a tag called "Hidden" is neither the builtin hidden flag nor an interface with that name.
+enum class EActorFlagKind : uint8
+{
+	Custom,
+	Tag,
+	Interface,
+	Builtin,
+};
+
+// Per-actor predicate cached as one bit in every index bucket, see UActorIndexSubsystem::DefineFlag.
+struct FActorFlag
+{
+	EActorFlagKind kind;
+	FName name;
+	TFunction<bool(const AActor*)> predicate;
+	bool perFrame;
+};
+
+// Dense per-class lists of actors, kept up to date from spawn and end play events. Opt-in per class:
+// world->GetSubsystem<UActorIndexSubsystem>()->EnableIndex<AFoo>(); after which ActorRange<AFoo> only visits matching actors.
+UCLASS()
+class GPUTILS_API UActorIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	// Starts indexing actors of the class and its subclasses. Scans the world once, later changes are applied incrementally.
+	// Enable the classes up front (e.g. from BeginPlay): adding a class invalidates ActorRanges that are being iterated.
+	void EnableIndex(UClass* actorClass);
+
+	template <class TActor>
+	void EnableIndex() { EnableIndex(TActor::StaticClass()); }
+
+	// Defines a flag evaluated for every indexed actor and returns its mask for ActorRange(world, required, excluded). At most 64 flags.
+	// Flags are evaluated when an actor is added and on RefreshFlags; perFrame flags (e.g. hidden) are also re-evaluated once per frame after the actor tick.
+	uint64 DefineFlag(FName name, TFunction<bool(const AActor*)> predicate, bool perFrame = false);
+	uint64 DefineTagFlag(FName tag);
+	uint64 DefineInterfaceFlag(UClass* interfaceClass);
+	uint64 DefineHiddenFlag();
+
+	// Mask of a flag defined earlier with DefineFlag, 0 when there is none with this name. The other Define*Flag functions return the existing mask
+	// when called again, there's no need to look those up.
+	uint64 GetFlag(FName name) const { return GetFlag(EActorFlagKind::Custom, name); }
+
+	// Re-evaluates the flags of the actor, call after changing its tags.
+	void RefreshFlags(AActor* actor);
+
+	// Tests the flag predicates directly, for actors of classes that aren't indexed.
+	bool Matches(const AActor* actor, uint64 required, uint64 excluded) const;
+
+	// Bucket of an indexed class, nullptr when the class isn't indexed. Actors removed during the current frame are nullptr.
+	const FActorIndexBucket* Find(UClass* actorClass) const;
+
+private:
+	UPROPERTY()
+	TMap<UClass*, FActorIndexBucket> buckets;
+
+	TArray<FActorFlag> flagDefinitions;
+
+	FDelegateHandle actorSpawned;
+	FDelegateHandle levelAdded;
+	FDelegateHandle postActorTick;
+	FDelegateHandle postGarbageCollect;
+
+	uint64 DefineFlag(EActorFlagKind kind, FName name, TFunction<bool(const AActor*)> predicate, bool perFrame);
+	uint64 GetFlag(EActorFlagKind kind, FName name) const;
+
+	void Add(AActor* actor, FActorIndexBucket& bucket);
+	void EvaluateFlags(FActorIndexBucket& bucket, int32 slot, bool perFrameOnly) const;
+	void OnActorSpawned(AActor* actor);
+
+	UFUNCTION()
+	void OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason);
+
+	void OnLevelAdded(ULevel* level, UWorld* world);
+	void Compact(UWorld* world, ELevelTick tickType, float deltaSeconds);
+	void OnPostGarbageCollect();
+};
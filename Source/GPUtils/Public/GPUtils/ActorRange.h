@@ -1,24 +1,162 @@
 #pragma once
 
+#include <GPUtils/ActorIndex.h>
+
 #include <CoreMinimal.h>
+#include <Engine/World.h>
 #include <EngineUtils.h>
 
 class UWorld;
 
+// Actors of the given class in the world. Reads the dense list of UActorIndexSubsystem when the class is indexed,
+// otherwise falls back to TActorIterator, which walks every actor of the class hash.
+//
+// Optionally filtered by flags defined on the index: ActorRange<AEnemy>(world, index->GetFlag(TEXT("Alive")), index->DefineHiddenFlag())
+// visits the actors that have every `required` flag and none of the `excluded` ones. On indexed classes this combines the flag bitsets
+// 32 actors at a time and jumps straight to the matches, without touching the actors that don't match.
 template <class TActor>
 class ActorRange
 {
 public:
 	using Element = TActor*;
 
-	ActorRange(UWorld* world_)
+	class Iterator
+	{
+	public:
+		Iterator() = default;
+
+		Iterator(UWorld* world, const UActorIndexSubsystem* index_, const FActorIndexBucket* bucket_, uint64 required_, uint64 excluded_)
+			: index(index_)
+			, bucket(bucket_)
+			, required(required_)
+			, excluded(excluded_)
+		{
+			if (bucket == nullptr)
+				scan.Emplace(world);
+			Skip();
+		}
+
+		FORCEINLINE_DEBUGGABLE TActor* operator*() const { return bucket ? static_cast<TActor*>(bucket->actors[slot]) : **scan; }
+		FORCEINLINE_DEBUGGABLE TActor* operator->() const { return **this; }
+		FORCEINLINE_DEBUGGABLE explicit operator bool() const { return bucket ? slot < bucket->actors.Num() : scan.IsSet() && static_cast<bool>(scan.GetValue()); }
+
+		FORCEINLINE_DEBUGGABLE Iterator& operator++()
+		{
+			if (bucket)
+				++slot;
+			else
+				++scan.GetValue();
+			Skip();
+			return *this;
+		}
+
+		FORCEINLINE_DEBUGGABLE bool operator!=(const Iterator& other) const { return static_cast<bool>(*this) != static_cast<bool>(other); }
+
+		// Bit j is set when the actor in slot `word` * 32 + j is present and has all required and none of the excluded flags.
+		static uint32 MatchWord(const FActorIndexBucket& bucket, uint64 required, uint64 excluded, int32 word)
+		{
+			auto ret = bucket.present.GetData()[word];
+			for (auto flags = required | excluded; flags != 0; flags &= flags - 1)
+			{
+				const auto flag = static_cast<int32>(FMath::CountTrailingZeros64(flags));
+				if (flag >= bucket.flags.Num())
+				{
+					if (required & (uint64(1) << flag))
+						return 0;
+					continue;
+				}
+
+				const auto bits = bucket.flags[flag].GetData()[word];
+				ret &= (required & (uint64(1) << flag)) ? bits : ~bits;
+			}
+			return ret;
+		}
+
+	private:
+		// Spawned actors are appended and removed ones are nulled out until the end of the frame, so indexing stays valid while the loop body spawns or destroys actors.
+		const UActorIndexSubsystem* index = nullptr;
+		const FActorIndexBucket* bucket = nullptr;
+		uint64 required = 0;
+		uint64 excluded = 0;
+		int32 slot = 0;
+		TOptional<TActorIterator<TActor>> scan;
+
+		FORCEINLINE_DEBUGGABLE void Skip()
+		{
+			if (bucket == nullptr)
+			{
+				if ((required | excluded) != 0 && index)
+					while (scan.GetValue() && !index->Matches(*scan.GetValue(), required, excluded))
+						++scan.GetValue();
+				return;
+			}
+
+			const auto num = bucket->actors.Num();
+			if ((required | excluded) == 0)
+			{
+				while (slot < num && !IsValid(bucket->actors[slot]))
+					++slot;
+				return;
+			}
+
+			while (slot < num)
+			{
+				const auto word = MatchWord(*bucket, required, excluded, slot / NumBitsPerDWORD) >> (slot % NumBitsPerDWORD);
+				if (word == 0)
+				{
+					slot = (slot / NumBitsPerDWORD + 1) * NumBitsPerDWORD;
+					continue;
+				}
+
+				slot += FMath::CountTrailingZeros(word);
+				if (slot >= num || IsValid(bucket->actors[slot]))
+					return;
+				++slot;
+			}
+		}
+	};
+
+	ActorRange(UWorld* world_, uint64 required_ = 0, uint64 excluded_ = 0)
 		: world(world_)
+		, index(world ? world->GetSubsystem<UActorIndexSubsystem>() : nullptr)
+		, bucket(index ? index->Find(TActor::StaticClass()) : nullptr)
+		, required(required_)
+		, excluded(excluded_)
 	{
 	}
 
-	FORCEINLINE_DEBUGGABLE auto begin() const { return TActorIterator<TActor>{ world }; }
-	FORCEINLINE_DEBUGGABLE auto end() const { return TActorIterator<TActor>{ EActorIteratorType::End }; }
+	FORCEINLINE_DEBUGGABLE Iterator begin() const { return { world, index, bucket, required, excluded, }; }
+	FORCEINLINE_DEBUGGABLE Iterator end() const { return {}; }
+
+	// Popcount over the flag bitsets for indexed classes, a full iteration otherwise.
+	int32 Num() const
+	{
+		if (bucket == nullptr)
+		{
+			auto ret = 0;
+			for (auto it = begin(); it; ++it)
+				++ret;
+			return ret;
+		}
+
+		const auto num = bucket->actors.Num();
+		if ((required | excluded) == 0)
+			return num - bucket->removed;
+
+		auto ret = 0;
+		for (auto word = 0; word * NumBitsPerDWORD < num; ++word)
+		{
+			const auto valid = num - word * NumBitsPerDWORD;
+			const auto mask = valid >= NumBitsPerDWORD ? ~0u : (1u << valid) - 1;
+			ret += FMath::CountBits(Iterator::MatchWord(*bucket, required, excluded, word) & mask);
+		}
+		return ret;
+	}
 
 private:
 	UWorld* world;
+	const UActorIndexSubsystem* index;
+	const FActorIndexBucket* bucket;
+	uint64 required;
+	uint64 excluded;
 };
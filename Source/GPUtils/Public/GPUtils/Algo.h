@@ -13,7 +13,7 @@ namespace Algo
     auto FromTuple() { return [](auto tuple) { return tuple.ApplyBefore([](auto... elements) { return TTo{ elements... }; }); }; }
 
     template <class TTo, std::size_t first, std::size_t... indices>
-    auto FromTuple() { return [](auto tuple) { return TTo{ tuple.Get<first>(), tuple.Get<indices>()... }; }; }
+    auto FromTuple() { return [](auto tuple) { return TTo{ tuple.template Get<first>(), tuple.template Get<indices>()... }; }; }
 
     template <class TTo>
     auto CastTuple() { return [](auto tuple) { return tuple.ApplyBefore([](auto... elements) { return MakeTuple(static_cast<TTo>(elements)...); }); }; }
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <GPUtils/Iterators.h>
+#include <GPUtils/Range.h>
+#include <GPUtils/Simd.h>
+
+#include <CoreMinimal.h>
+
+namespace Range
+{
+    namespace Types
+    {
+        // Arithmetic range yielding Simd::Lanes instead of single values. The last pack may be partial.
+        template <class TValue, TValue delta = static_cast<TValue>(1)>
+        struct Batched
+        {
+        private:
+            struct IteratorCtorLocker {};
+
+        public:
+            using Value = Simd::Lanes<TValue>;
+
+            struct ConstIterator : Iterators::ConstBase<Value, ConstIterator>
+            {
+            private:
+                using Base = Iterators::ConstBase<Value, ConstIterator>;
+                friend Base;
+
+            public:
+                FORCEINLINE_DEBUGGABLE ConstIterator() = default;
+
+                FORCEINLINE_DEBUGGABLE ConstIterator(IteratorCtorLocker, TValue from, TValue to_)
+                    : Base((from <= to_) ? Fill(from, to_) : ::Types::Optional<Value>{})
+                    , to(to_)
+                {
+                }
+
+            protected:
+                FORCEINLINE_DEBUGGABLE bool Equals(const ConstIterator& other) const
+                {
+                    check(this->to == other.to);
+                    return Base::GetValue().values[0] == static_cast<const Base&>(other).GetValue().values[0];
+                }
+
+                FORCEINLINE_DEBUGGABLE ::Types::Optional<Value> ShiftForward()
+                {
+                    const auto& v = Base::GetValue();
+                    const auto last = v.values[Value::width - 1];
+                    if (!v.IsFull() || to - last < delta)
+                        return {};
+                    return Fill(last + delta, to);
+                }
+
+                TValue to;
+
+            private:
+                static FORCEINLINE_DEBUGGABLE Value Fill(TValue first, TValue to)
+                {
+                    auto ret = Value{};
+                    ret.count = 0;
+                    for (auto v = first;; v += delta)
+                    {
+                        ret.values[ret.count++] = v;
+                        if (ret.IsFull() || to - v < delta)
+                            break;
+                    }
+                    ret.Pad();
+                    return ret;
+                }
+            };
+
+            FORCEINLINE_DEBUGGABLE Batched(TValue from_, TValue to_) : from(from_), to(to_) {}
+            FORCEINLINE_DEBUGGABLE ConstIterator begin() const { return { IteratorCtorLocker{}, from, to, }; }
+            FORCEINLINE_DEBUGGABLE ConstIterator end() const { return {}; }
+
+            FORCEINLINE_DEBUGGABLE int32 Num() const
+            {
+                const auto values = Types::Range<TValue, delta>{ from, to, }.Num();
+                return (values + Value::width - 1) / Value::width;
+            }
+
+        private:
+            TValue from;
+            TValue to;
+        };
+    }
+
+    template <class TValue, TValue delta>
+    auto Batch(const Types::Range<TValue, delta>& range)
+    {
+        static_assert(delta > 0, "Only ascending ranges can be batched.");
+        return Types::Batched<TValue, delta>{ range.GetFrom(), range.GetTo(), };
+    }
+
+    template <class TValue, TValue delta>
+    constexpr bool IsRange<Types::Batched<TValue, delta>> = true;
+
+    namespace Detail
+    {
+        template <class TRange, class TOperation>
+        auto Reduce(const TRange& range, TOperation operation)
+        {
+            using Lanes = typename TRange::Value;
+            using Element = typename Lanes::Value;
+
+            auto packed = TOptional<Lanes>{};
+            auto ret = TOptional<Element>{};
+            for (const auto& lanes : range)
+            {
+                if (lanes.IsFull())
+                {
+                    packed = packed ? operation(*packed, lanes) : lanes;
+                    continue;
+                }
+                for (auto i = 0; i < lanes.count; ++i)
+                    ret = ret ? operation(*ret, lanes.values[i]) : lanes.values[i];
+            }
+
+            if (packed)
+                for (const auto& v : packed->values)
+                    ret = ret ? operation(*ret, v) : v;
+            return ret;
+        }
+    }
+
+    // Sum, Min and Max of the values of a batched range, unset when it's empty.
+    template <class TRange>
+    auto Sum(const TRange& range)
+    {
+        static_assert(Simd::IsLanes<typename TRange::Value>, "Sum expects a batched range, see Range::Batch.");
+        return Detail::Reduce(range, [](const auto& l, const auto& r) { return l + r; });
+    }
+
+    template <class TRange>
+    auto Min(const TRange& range)
+    {
+        static_assert(Simd::IsLanes<typename TRange::Value>, "Min expects a batched range, see Range::Batch.");
+        return Detail::Reduce(range, [](const auto& l, const auto& r) { return Simd::Min(l, r); });
+    }
+
+    template <class TRange>
+    auto Max(const TRange& range)
+    {
+        static_assert(Simd::IsLanes<typename TRange::Value>, "Max expects a batched range, see Range::Batch.");
+        return Detail::Reduce(range, [](const auto& l, const auto& r) { return Simd::Max(l, r); });
+    }
+
+    template <class TLeft, class TRight>
+    auto Dot(const TLeft& left, const TRight& right)
+    {
+        static_assert(Simd::IsLanes<typename TLeft::Value> && ::Types::AreSame<typename TLeft::Value, typename TRight::Value>, "Dot expects two batched ranges of the same type.");
+        using Lanes = typename TLeft::Value;
+        using Element = typename Lanes::Value;
+
+        auto packed = Lanes::Splat(0);
+        auto tail = Element{ 0 };
+        auto l = left.begin();
+        auto r = right.begin();
+        for (; l != left.end() && r != right.end(); ++l, ++r)
+        {
+            const auto a = *l;
+            const auto b = *r;
+            check(a.count == b.count);
+            if (a.IsFull())
+            {
+                packed = packed + a * b;
+                continue;
+            }
+            for (auto i = 0; i < a.count; ++i)
+                tail += a.values[i] * b.values[i];
+        }
+        check(l == left.end() && r == right.end());
+
+        for (const auto& v : packed.values)
+            tail += v;
+        return tail;
+    }
+}
+
+template <class TFunctor, class TValue, TValue delta>
+FORCEINLINE auto operator|(Range::Types::Batched<TValue, delta> left, TFunctor right)
+{
+    using TTo = decltype(Simd::Apply(right, *left.begin()));
+    const auto functor = [right](const auto& lanes) { return Simd::Apply(right, lanes); };
+    return Range::Types::Map<Range::Types::Batched<TValue, delta>, TTo, decltype(functor)>{ left, functor, };
+}
+
+template <class TFunctor, class TRange, class TValue, class TInnerFunctor>
+FORCEINLINE auto operator|(Range::Types::Map<TRange, Simd::Lanes<TValue>, TInnerFunctor> left, TFunctor right)
+{
+    using TTo = decltype(Simd::Apply(right, *left.begin()));
+    const auto functor = [right](const auto& lanes) { return Simd::Apply(right, lanes); };
+    return Range::Types::Map<Range::Types::Map<TRange, Simd::Lanes<TValue>, TInnerFunctor>, TTo, decltype(functor)>{ left, functor, };
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <GPUtils/Collect.h>
+#include <GPUtils/Iterators.h>
+#include <GPUtils/Range.h>
+#include <GPUtils/View.h>
+
+#include <CoreMinimal.h>
+
+namespace Range
+{
+    namespace Types
+    {
+        // Remembers the current element of the wrapped range, so repeated dereferencing (operator->, Join over several ranges) runs an expensive Map only once per position.
+        template <class TRange>
+        struct Cached
+        {
+        private:
+            struct IteratorCtorLocker {};
+            using InnerIterator = typename TRange::ConstIterator;
+
+        public:
+            using Value = ElementOf<TRange>;
+
+            struct ConstIterator : Iterators::ConstBase<InnerIterator, ConstIterator>
+            {
+            private:
+                using Base = Iterators::ConstBase<InnerIterator, ConstIterator>;
+                friend Base;
+
+            public:
+                FORCEINLINE_DEBUGGABLE constexpr operator bool() const { return static_cast<const Base&>(*this) && Base::GetValue(); }
+
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
+
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, InnerIterator&& iterator)
+                    : Base(std::move(iterator))
+                {
+                }
+
+            protected:
+                FORCEINLINE_DEBUGGABLE constexpr const Value& GetValue() const
+                {
+                    GPUTILS_CHECK(*this);
+                    if (!cache)
+                        cache = *Base::GetValue();
+                    return cache.GetValue();
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
+                {
+                    return Base::GetValue() == static_cast<const Base&>(other).GetValue();
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<InnerIterator> ShiftForward()
+                {
+                    cache.Reset();
+                    auto v = Base::GetValue();
+                    if (!++v)
+                        return {};
+                    return v;
+                }
+
+                mutable ::Types::Optional<Value> cache;
+            };
+
+            FORCEINLINE_DEBUGGABLE constexpr Cached(TRange range_) : range(std::move(range_)) {}
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, range.begin(), }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return { IteratorCtorLocker{}, range.end(), }; }
+
+            template <bool sized = ::Types::HasNum<TRange>>
+            FORCEINLINE_DEBUGGABLE constexpr ::Types::EnableIf<sized, int32> Num() const { return range.Num(); }
+
+        private:
+            TRange range;
+        };
+
+        // Evaluates the wrapped range once into a buffer shared by all copies, then iterates it as a View.
+        // Meant for the inner ranges of a Join, which are otherwise iterated (and mapped) again for every outer element.
+        template <class TValue>
+        struct Precomputed
+        {
+        public:
+            using Value = TValue;
+            using ConstIterator = typename View<TValue>::ConstIterator;
+
+            FORCEINLINE_DEBUGGABLE Precomputed(TArray<TValue>&& values_)
+                : values(MakeShared<TArray<TValue>>(MoveTemp(values_)))
+                , view(values->GetData(), values->Num())
+            {
+            }
+
+            FORCEINLINE_DEBUGGABLE ConstIterator begin() const { return view.begin(); }
+            FORCEINLINE_DEBUGGABLE ConstIterator end() const { return view.end(); }
+            FORCEINLINE_DEBUGGABLE ConstIterator Last() const { return view.Last(); }
+
+            FORCEINLINE_DEBUGGABLE int32 Num() const { return view.Num(); }
+            FORCEINLINE_DEBUGGABLE const TValue* GetData() const { return view.GetData(); }
+
+        private:
+            TSharedRef<const TArray<TValue>> values;
+            View<TValue> view;
+        };
+    }
+
+    template <class TRange>
+    constexpr auto Cache(TRange range) { return Types::Cached<TRange>{ std::move(range), }; }
+
+    template <class TRange>
+    auto Precompute(const TRange& range) { return Types::Precomputed<ElementOf<TRange>>{ ToArray(range), }; }
+
+    // Precomputes every range of the Join, so the functors of mapped ranges run O(a + b) times instead of O(a * b) during the sweep.
+    template <class... TRanges>
+    auto Precompute(const Types::Join<TRanges...>& join)
+    {
+        return join.GetRanges().ApplyBefore([](const auto&... ranges) { return Join(Precompute(ranges)...); });
+    }
+
+    template <class TRange>
+    constexpr bool IsRange<Types::Cached<TRange>> = true;
+
+    template <class TValue>
+    constexpr bool IsRange<Types::Precomputed<TValue>> = true;
+
+    template <class TValue>
+    constexpr bool IsContiguous<Types::Precomputed<TValue>> = true;
+}
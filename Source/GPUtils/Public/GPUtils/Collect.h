@@ -0,0 +1,93 @@
+#pragma once
+
+#include <GPUtils/Algo.h>
+#include <GPUtils/Range.h>
+#include <GPUtils/Types.h>
+
+#include <CoreMinimal.h>
+
+#include <array>
+
+namespace Range
+{
+    template <class TRange>
+    using ElementOf = typename TDecay<decltype(*DeclVal<const TRange&>().begin())>::Type;
+
+    // Appends every element of the range, reserving once up front when the range knows its size. Contiguous ranges of the same element type are appended in bulk.
+    template <class TRange, class TElement, class TAllocator>
+    void CollectInto(const TRange& range, TArray<TElement, TAllocator>& to)
+    {
+        if constexpr (IsContiguous<TRange> && ::Types::AreSame<ElementOf<TRange>, TElement>)
+        {
+            to.Append(range.GetData(), range.Num());
+        }
+        else
+        {
+            if constexpr (::Types::HasNum<TRange>)
+                to.Reserve(to.Num() + range.Num());
+
+            for (auto&& element : range)
+                to.Emplace(Forward<decltype(element)>(element));
+        }
+    }
+
+    template <class TRange>
+    auto ToArray(const TRange& range)
+    {
+        auto ret = TArray<ElementOf<TRange>>{};
+        CollectInto(range, ret);
+        return ret;
+    }
+
+    // Structure of arrays variant for ranges of tuples (e.g. Join): element i of every tuple goes to arrays[i].
+    template <class TRange, class... TArrays>
+    void CollectSoAInto(const TRange& range, TArrays&... arrays)
+    {
+        static_assert(Algo::TupleSize<ElementOf<TRange>> == sizeof...(TArrays), "Number of arrays doesn't match the tuple size.");
+
+        if constexpr (::Types::HasNum<TRange>)
+        {
+            const auto num = range.Num();
+            (arrays.Reserve(arrays.Num() + num), ...);
+        }
+
+        for (auto&& element : range)
+            Forward<decltype(element)>(element).ApplyBefore([&](auto&&... fields) { (arrays.Emplace(Forward<decltype(fields)>(fields)), ...); });
+    }
+
+    namespace Detail
+    {
+        template <class TElement>
+        struct SoA;
+
+        template <class... TFields>
+        struct SoA<TTuple<TFields...>>
+        {
+            using Type = TTuple<TArray<TFields>...>;
+        };
+    }
+
+    template <class TRange>
+    auto ToSoA(const TRange& range)
+    {
+        auto ret = typename Detail::SoA<ElementOf<TRange>>::Type{};
+        ret.ApplyBefore([&](auto&... arrays) { CollectSoAInto(range, arrays...); });
+        return ret;
+    }
+
+    // Fills a fixed size array from the range. Works in constexpr context, so lookup tables can be baked into the binary:
+    // constexpr auto table = Range::ToStaticArray<256>(Range::Make(0, 255) | [](int32 i) { return i * i; });
+    template <std::size_t size, class TRange>
+    constexpr auto ToStaticArray(const TRange& range)
+    {
+        auto ret = std::array<ElementOf<TRange>, size>{};
+        auto it = range.begin();
+        for (auto& element : ret)
+        {
+            GPUTILS_CHECK(it != range.end());
+            element = *it;
+            ++it;
+        }
+        return ret;
+    }
+}
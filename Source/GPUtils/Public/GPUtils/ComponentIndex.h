@@ -0,0 +1,90 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Engine/EngineBaseTypes.h>
+#include <Engine/EngineTypes.h>
+#include <Subsystems/WorldSubsystem.h>
+
+#include "ComponentIndex.generated.h"
+
+class AActor;
+class UActorComponent;
+class ULevel;
+
+USTRUCT()
+struct FComponentIndexBucket
+{
+	GENERATED_BODY()
+
+	// Removed components are nulled out and compacted away after the actor tick, like FActorIndexBucket. So are the ones destroyed without being
+	// unregistered, once the garbage collector has nulled them.
+	UPROPERTY()
+	TArray<UActorComponent*> components;
+
+	TMap<UActorComponent*, int32> slots;
+	int32 removed = 0;
+
+	// Bit i is set when components[i] has the tag / implements the interface. Kept in step with components.
+	TMap<FName, TBitArray<>> tags;
+	TMap<UClass*, TBitArray<>> interfaces;
+};
+
+// Dense per-class lists of the registered components of a world, opt-in per class like UActorIndexSubsystem:
+// world->GetSubsystem<UComponentIndexSubsystem>()->EnableIndex<UPrimitiveComponent>(); ...->EnableTagFilter<UPrimitiveComponent>(TEXT("Interactive"));
+// Components are picked up with their actors (spawn, streamed in levels) and dropped at end play. The engine has no global component registration event,
+// so components added to or removed from a live actor should be reported with NotifyRegistered / NotifyUnregistered (e.g. from OnRegister / OnUnregister).
+UCLASS()
+class GPUTILS_API UComponentIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	// Starts indexing components of the class and its subclasses. Scans the world once, later changes are applied incrementally.
+	void EnableIndex(UClass* componentClass);
+
+	// Precomputes a bitset of the indexed components that have the tag. Tags are read when a component is added, call NotifyRegistered again after changing them.
+	void EnableTagFilter(UClass* componentClass, FName tag);
+
+	// Precomputes a bitset of the indexed components that implement the interface.
+	void EnableInterfaceFilter(UClass* componentClass, UClass* interfaceClass);
+
+	template <class TComponent>
+	void EnableIndex() { EnableIndex(TComponent::StaticClass()); }
+
+	template <class TComponent>
+	void EnableTagFilter(FName tag) { EnableTagFilter(TComponent::StaticClass(), tag); }
+
+	template <class TComponent, class TInterface>
+	void EnableInterfaceFilter() { EnableInterfaceFilter(TComponent::StaticClass(), TInterface::UClassType::StaticClass()); }
+
+	void NotifyRegistered(UActorComponent* component);
+	void NotifyUnregistered(UActorComponent* component);
+
+	// Bucket of an indexed class, nullptr when the class isn't indexed.
+	const FComponentIndexBucket* Find(UClass* componentClass) const;
+
+private:
+	UPROPERTY()
+	TMap<UClass*, FComponentIndexBucket> buckets;
+
+	FDelegateHandle actorSpawned;
+	FDelegateHandle levelAdded;
+	FDelegateHandle postActorTick;
+	FDelegateHandle postGarbageCollect;
+	bool collected = false;
+
+	void Add(UActorComponent* component, FComponentIndexBucket& bucket);
+	void Remove(UActorComponent* component, FComponentIndexBucket& bucket);
+	void AddActor(AActor* actor, UClass* componentClass, FComponentIndexBucket& bucket);
+	void OnActorSpawned(AActor* actor);
+
+	UFUNCTION()
+	void OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason);
+
+	void OnLevelAdded(ULevel* level, UWorld* world);
+	void Compact(UWorld* world, ELevelTick tickType, float deltaSeconds);
+	void OnPostGarbageCollect() { collected = true; }
+};
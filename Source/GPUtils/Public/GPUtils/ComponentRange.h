@@ -0,0 +1,137 @@
+#pragma once
+
+#include <GPUtils/ComponentIndex.h>
+
+#include <Components/ActorComponent.h>
+#include <CoreMinimal.h>
+#include <Engine/World.h>
+#include <UObject/UObjectIterator.h>
+
+class UWorld;
+
+// Registered components of the given class in the world, optionally only the ones with a tag and / or implementing an interface.
+// Reads the dense list of UComponentIndexSubsystem when the class is indexed. Filters with a precomputed bitset skip 32 non-matching components
+// per step, others are tested per component. Unindexed classes fall back to one pass over TObjectIterator when iteration starts.
+template <class TComponent>
+class ComponentRange
+{
+public:
+	using Element = TComponent*;
+
+	class Iterator
+	{
+	public:
+		Iterator() = default;
+
+		Iterator(const TArray<UActorComponent*>* components_, const TBitArray<>* bits_, FName tag_, UClass* interfaceClass_)
+			: components(components_)
+			, bits(bits_)
+			, tag(tag_)
+			, interfaceClass(interfaceClass_)
+		{
+			Skip();
+		}
+
+		FORCEINLINE_DEBUGGABLE TComponent* operator*() const { return static_cast<TComponent*>((*components)[index]); }
+		FORCEINLINE_DEBUGGABLE TComponent* operator->() const { return **this; }
+		FORCEINLINE_DEBUGGABLE explicit operator bool() const { return components && index < components->Num(); }
+
+		FORCEINLINE_DEBUGGABLE Iterator& operator++()
+		{
+			++index;
+			Skip();
+			return *this;
+		}
+
+		FORCEINLINE_DEBUGGABLE bool operator!=(const Iterator& other) const { return static_cast<bool>(*this) != static_cast<bool>(other); }
+
+	private:
+		const TArray<UActorComponent*>* components = nullptr;
+		const TBitArray<>* bits = nullptr;
+		FName tag;
+		UClass* interfaceClass = nullptr;
+		int32 index = 0;
+
+		FORCEINLINE_DEBUGGABLE bool Matches(const UActorComponent* component) const
+		{
+			return IsValid(component)
+				&& (tag.IsNone() || component->ComponentHasTag(tag))
+				&& (interfaceClass == nullptr || component->GetClass()->ImplementsInterface(interfaceClass));
+		}
+
+		FORCEINLINE_DEBUGGABLE void Skip()
+		{
+			if (components == nullptr)
+				return;
+
+			const auto num = components->Num();
+			if (bits == nullptr)
+			{
+				while (index < num && !Matches((*components)[index]))
+					++index;
+				return;
+			}
+
+			const auto words = bits->GetData();
+			while (index < num)
+			{
+				const auto word = words[index / NumBitsPerDWORD] >> (index % NumBitsPerDWORD);
+				if (word == 0)
+				{
+					index = (index / NumBitsPerDWORD + 1) * NumBitsPerDWORD;
+					continue;
+				}
+
+				index += FMath::CountTrailingZeros(word);
+				if (index >= num || Matches((*components)[index]))
+					return;
+				++index;
+			}
+		}
+	};
+
+	ComponentRange(UWorld* world_, FName tag_ = NAME_None, UClass* interfaceClass_ = nullptr)
+		: world(world_)
+		, tag(tag_)
+		, interfaceClass(interfaceClass_)
+	{
+		const auto index = world ? world->GetSubsystem<UComponentIndexSubsystem>() : nullptr;
+		bucket = index ? index->Find(TComponent::StaticClass()) : nullptr;
+	}
+
+	template <class TInterface>
+	static ComponentRange WithInterface(UWorld* world, FName tag = NAME_None) { return { world, tag, TInterface::UClassType::StaticClass(), }; }
+
+	Iterator begin() const
+	{
+		if (bucket == nullptr)
+		{
+			Gather();
+			return { &gathered, nullptr, tag, interfaceClass, };
+		}
+
+		// The bitset makes its filter exact, so only the remaining one (if any) is tested per component.
+		if (const auto tagBits = tag.IsNone() ? nullptr : bucket->tags.Find(tag))
+			return { &bucket->components, tagBits, NAME_None, interfaceClass, };
+		if (const auto interfaceBits = interfaceClass ? bucket->interfaces.Find(interfaceClass) : nullptr)
+			return { &bucket->components, interfaceBits, tag, nullptr, };
+		return { &bucket->components, nullptr, tag, interfaceClass, };
+	}
+
+	Iterator end() const { return {}; }
+
+private:
+	UWorld* world;
+	FName tag;
+	UClass* interfaceClass;
+	const FComponentIndexBucket* bucket;
+	mutable TArray<UActorComponent*> gathered;
+
+	void Gather() const
+	{
+		gathered.Reset();
+		for (TObjectIterator<TComponent> it; it; ++it)
+			if (it->IsRegistered() && it->GetWorld() == world)
+				gathered.Add(*it);
+	}
+};
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <GPUtils/HopStats.h>
+#include <GPUtils/Threads.h>
+
+#include <Async/Future.h>
+#include <CoreMinimal.h>
+#include <Misc/IQueuedWork.h>
+#include <Misc/QueuedThreadPool.h>
+
+#include <atomic>
+#include <coroutine>
+
+// Coroutine tasks for multi-step async flows, written as straight-line code:
+//
+// Coro::Task<UTexture2D*> LoadAvatar(FString path)
+// {
+//     co_await Coro::ToThreadPool();
+//     auto data = ReadFile(path);
+//     co_await Coro::ToGameThread();
+//     co_return MakeTexture(data);
+// }
+//
+// Tasks are lazy: they run when awaited by another task or when started with Start(), which also makes them own themselves.
+// Frames come from a pool of fixed size blocks, a hop between threads costs one queue entry instead of a delegate and a future state.
+// TFutures can be awaited directly, online subsystem style callbacks with WaitFor.
+namespace Coro
+{
+	// Pooled storage of coroutine frames, safe to free on another thread than the one that allocated.
+	GPUTILS_API void* AllocateFrame(SIZE_T size);
+	GPUTILS_API void FreeFrame(void* frame, SIZE_T size);
+
+	template <class T>
+	class Task;
+
+	namespace Detail
+	{
+		template <class T>
+		struct Storage
+		{
+			TOptional<T> value;
+
+			template <class TFrom>
+			void Set(TFrom&& from) { value.Emplace(Forward<TFrom>(from)); }
+			T Take() { return MoveTemp(value.GetValue()); }
+		};
+
+		template <>
+		struct Storage<void>
+		{
+			void Take() {}
+		};
+
+		template <class T>
+		class FutureAwaiter
+		{
+		public:
+			explicit FutureAwaiter(TFuture<T>&& future_) : future(MoveTemp(future_)) {}
+
+			bool await_ready() const { return future.IsReady(); }
+
+			void await_suspend(std::coroutine_handle<> continuation)
+			{
+				// The continuation may run (and destroy this awaiter) before Then returns, so the future is moved out first.
+				const auto gameThread = IsInGameThread();
+				auto pending = MoveTemp(future);
+				pending.Then([this, continuation, gameThread](TFuture<T> done)
+					{
+						Store(done);
+						if (gameThread)
+							ExecuteInGameThread(InstrumentHop(GPUTILS_HOP_TAG("Coro.Future"), [continuation] { continuation.resume(); }));
+						else
+							continuation.resume();
+					});
+			}
+
+			T await_resume()
+			{
+				if (future.IsValid())
+					Store(future);
+				return result.Take();
+			}
+
+		private:
+			TFuture<T> future;
+			Storage<T> result;
+
+			void Store(TFuture<T>& done)
+			{
+				if constexpr (!std::is_void_v<T>)
+					result.Set(done.Get());
+			}
+		};
+
+		struct PromiseBase
+		{
+			std::coroutine_handle<> continuation;
+			bool detached = false;
+
+			static void* operator new(std::size_t size) { return AllocateFrame(size); }
+			static void operator delete(void* frame, std::size_t size) { FreeFrame(frame, size); }
+
+			struct FinalAwaiter
+			{
+				bool await_ready() const noexcept { return false; }
+
+				template <class TPromise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> self) noexcept
+				{
+					auto& promise = self.promise();
+					if (promise.continuation)
+						return promise.continuation;
+					if (promise.detached)
+						self.destroy();
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			FinalAwaiter final_suspend() const noexcept { return {}; }
+
+			// Modules are built without exceptions.
+			void unhandled_exception() const { checkNoEntry(); }
+
+			template <class TAwaitable>
+			TAwaitable&& await_transform(TAwaitable&& awaitable) const { return Forward<TAwaitable>(awaitable); }
+
+			template <class T>
+			FutureAwaiter<T> await_transform(TFuture<T>&& future) const { return FutureAwaiter<T>{ MoveTemp(future) }; }
+		};
+
+		template <class T>
+		struct Promise : PromiseBase
+		{
+			Storage<T> result;
+
+			Task<T> get_return_object();
+
+			template <class TFrom>
+			void return_value(TFrom&& from) { result.Set(Forward<TFrom>(from)); }
+		};
+
+		template <>
+		struct Promise<void> : PromiseBase
+		{
+			Storage<void> result;
+
+			Task<void> get_return_object();
+
+			void return_void() const {}
+		};
+	}
+
+	template <class T = void>
+	class [[nodiscard]] Task
+	{
+	public:
+		using promise_type = Detail::Promise<T>;
+
+		Task() = default;
+		explicit Task(std::coroutine_handle<promise_type> handle_) : handle(handle_) {}
+		Task(Task&& other) : handle(other.handle) { other.handle = nullptr; }
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		Task& operator=(Task&& other)
+		{
+			if (this != &other)
+			{
+				if (handle)
+					handle.destroy();
+				handle = other.handle;
+				other.handle = nullptr;
+			}
+			return *this;
+		}
+
+		~Task()
+		{
+			if (handle)
+				handle.destroy();
+		}
+
+		// Runs the task until its first suspension. The frame frees itself when the task completes.
+		void Start() &&
+		{
+			check(handle);
+			const auto started = handle;
+			handle = nullptr;
+			started.promise().detached = true;
+			started.resume();
+		}
+
+		// Awaiting starts the task and continues the awaiting one on the thread where it completed.
+		auto operator co_await() && noexcept
+		{
+			struct Awaiter
+			{
+				std::coroutine_handle<promise_type> handle;
+
+				bool await_ready() const noexcept { return false; }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) const noexcept
+				{
+					handle.promise().continuation = continuation;
+					return handle;
+				}
+
+				T await_resume() const { return handle.promise().result.Take(); }
+			};
+			check(handle);
+			return Awaiter{ handle };
+		}
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+	};
+
+	namespace Detail
+	{
+		template <class T>
+		Task<T> Promise<T>::get_return_object() { return Task<T>{ std::coroutine_handle<Promise>::from_promise(*this) }; }
+
+		inline Task<void> Promise<void>::get_return_object() { return Task<void>{ std::coroutine_handle<Promise>::from_promise(*this) }; }
+	}
+
+	// Continues on the game thread, through the ExecuteInGameThread queue. Doesn't suspend when already there.
+	struct ToGameThread
+	{
+		bool await_ready() const { return IsInGameThread(); }
+		void await_suspend(std::coroutine_handle<> continuation) const { ExecuteInGameThread(InstrumentHop(GPUTILS_HOP_TAG("Coro.ToGameThread"), [continuation] { continuation.resume(); })); }
+		void await_resume() const {}
+	};
+
+	// Continues right away while this frame's game thread budget lasts, otherwise as a budgeted step of the next frame. Lets long game thread loops
+	// spread over frames: for (auto& entry : entries) { co_await Coro::YieldToBudget(); Spawn(entry); }
+	struct YieldToBudget
+	{
+		EJobPriority priority = EJobPriority::Normal;
+
+		bool await_ready() const { return IsInGameThread() && !IsGameThreadBudgetExhausted(); }
+
+		void await_suspend(std::coroutine_handle<> continuation) const
+		{
+			ExecuteInGameThreadBudgeted([continuation]
+				{
+					continuation.resume();
+					return false;
+				}, priority);
+		}
+
+		void await_resume() const {}
+	};
+
+	// Continues on a thread of the pool. The awaiter is the queued work item itself, so the hop allocates nothing.
+	class ToThreadPool final : public IQueuedWork
+	{
+	public:
+		explicit ToThreadPool(FQueuedThreadPool* pool_ = GThreadPool) : pool(pool_) {}
+
+		bool await_ready() const { return false; }
+
+		void await_suspend(std::coroutine_handle<> continuation_)
+		{
+			continuation = continuation_;
+#if GPUTILS_HOP_STATS
+			enqueued = FPlatformTime::Cycles64();
+#endif
+			pool->AddQueuedWork(this);
+		}
+
+		void await_resume() const {}
+
+		virtual void DoThreadedWork() override
+		{
+			GPUTILS_HOP_SCOPE(GPUTILS_HOP_TAG("Coro.ToThreadPool"), enqueued);
+			continuation.resume();
+		}
+
+		// The pool is shutting down, finish on the calling thread rather than leak the frame.
+		virtual void Abandon() override { continuation.resume(); }
+
+	private:
+		FQueuedThreadPool* pool;
+		std::coroutine_handle<> continuation;
+#if GPUTILS_HOP_STATS
+		uint64 enqueued = 0;
+#endif
+	};
+
+	// Suspends until the callback handed to `subscribe` is called and returns its arguments as a tuple. `subscribe` binds the callback
+	// and starts the operation, returning the handle that is passed to `unsubscribe` once the callback fired. The callback may fire right away.
+	// Destroying the coroutine while it waits unsubscribes too, so `unsubscribe` must only use what outlives the co_await expression.
+	//
+	// const auto started = co_await Coro::WaitFor<FName, bool>(
+	//     [&](auto&& resume)
+	//     {
+	//         const auto handle = sessions->AddOnStartSessionCompleteDelegate_Handle(FOnStartSessionCompleteDelegate::CreateLambda(MoveTemp(resume)));
+	//         sessions->StartSession(name);
+	//         return handle;
+	//     },
+	//     [&](FDelegateHandle handle) { sessions->ClearOnStartSessionCompleteDelegate_Handle(handle); });
+	// if (!started.Get<1>()) ...
+	template <class TSubscribe, class TUnsubscribe, class... TArgs>
+	class CallbackAwaiter
+	{
+	public:
+		CallbackAwaiter(TSubscribe&& subscribe_, TUnsubscribe&& unsubscribe_)
+			: subscribe(MoveTemp(subscribe_))
+			, unsubscribe(MoveTemp(unsubscribe_))
+		{
+		}
+
+		// Only moved before it's awaited, some compilers copy the operand of co_await into the frame.
+		CallbackAwaiter(CallbackAwaiter&& other)
+			: subscribe(MoveTemp(other.subscribe))
+			, unsubscribe(MoveTemp(other.unsubscribe))
+		{
+		}
+
+		// The task was destroyed while waiting: a later call must neither resume the freed frame nor stay bound to it.
+		~CallbackAwaiter()
+		{
+			if (!subscribed)
+				return;
+			shared->state.exchange(Abandoned);
+			unsubscribe(handle);
+		}
+
+		bool await_ready() const { return false; }
+
+		bool await_suspend(std::coroutine_handle<> continuation_)
+		{
+			shared->continuation = continuation_;
+			subscribed = true;
+			handle = subscribe([shared = shared](TArgs... args) { Fire(*shared, args...); });
+			return shared->state.exchange(Suspended) != Fired;
+		}
+
+		TTuple<TArgs...> await_resume()
+		{
+			subscribed = false;
+			unsubscribe(handle);
+			return MoveTemp(shared->result.GetValue());
+		}
+
+	private:
+		enum : int32 { Subscribing, Suspended, Fired, Abandoned, };
+
+		// Owned by the callback as well as the frame, a call racing with or following the frame's destruction only writes here.
+		struct FShared
+		{
+			std::coroutine_handle<> continuation;
+			TOptional<TTuple<TArgs...>> result;
+			std::atomic<int32> state{ Subscribing };
+		};
+
+		TSubscribe subscribe;
+		TUnsubscribe unsubscribe;
+		FDelegateHandle handle;
+		bool subscribed = false;
+		TSharedRef<FShared, ESPMode::ThreadSafe> shared = MakeShared<FShared, ESPMode::ThreadSafe>();
+
+		static void Fire(FShared& shared, TArgs... args)
+		{
+			// Multicast delegates may broadcast again before the coroutine unsubscribed, only the first call counts.
+			if (shared.result.IsSet())
+				return;
+			shared.result.Emplace(args...);
+			if (shared.state.exchange(Fired) == Suspended)
+				shared.continuation.resume();
+		}
+	};
+
+	template <class... TArgs, class TSubscribe, class TUnsubscribe>
+	CallbackAwaiter<std::decay_t<TSubscribe>, std::decay_t<TUnsubscribe>, TArgs...> WaitFor(TSubscribe&& subscribe, TUnsubscribe&& unsubscribe)
+	{
+		return { std::decay_t<TSubscribe>(Forward<TSubscribe>(subscribe)), std::decay_t<TUnsubscribe>(Forward<TUnsubscribe>(unsubscribe)), };
+	}
+}
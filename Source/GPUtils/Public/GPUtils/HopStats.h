@@ -0,0 +1,82 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <HAL/PlatformTime.h>
+#include <ProfilingDebugging/CpuProfilerTrace.h>
+
+// Instrumentation of the work GPUtils hands over to other threads: how long it waited between being queued and starting, and how long it ran,
+// per call site tag. Every thread records into its own histograms without locks, they are merged when read. Runs also show up as CPU trace events
+// named after their tag in Insights. Dump percentiles with GPUtils.HopStats [reset]. Compiled out of shipping builds.
+#define GPUTILS_HOP_STATS !UE_BUILD_SHIPPING
+
+#if GPUTILS_HOP_STATS
+
+// Call site of hops, declared with GPUTILS_HOP_TAG. Tags with the same name share their stats, up to 32 names in total, further ones aren't recorded.
+class GPUTILS_API FHopTag
+{
+public:
+	const TCHAR* name;
+	int32 index;
+
+	explicit FHopTag(const TCHAR* name_);
+};
+
+// Records a hop on the calling thread: the wait since `enqueued` (FPlatformTime::Cycles64) when constructed, the run time when destroyed.
+class GPUTILS_API FHopScope
+{
+public:
+	FHopScope(const FHopTag& tag_, uint64 enqueued);
+	~FHopScope();
+
+private:
+	const FHopTag& tag;
+	uint64 start;
+};
+
+#define GPUTILS_HOP_TAG(name) ([]() -> const FHopTag& { static const FHopTag tag(TEXT(name)); return tag; }())
+#define GPUTILS_HOP_SCOPE(tag, enqueued) \
+	const FHopScope PREPROCESSOR_JOIN(hopScope, __LINE__)(tag, enqueued); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT((tag).name)
+
+// Wraps work that is about to be queued, so that its wait from now and its run are recorded under the tag:
+// AsyncTask(ENamedThreads::GameThread, InstrumentHop(GPUTILS_HOP_TAG("Inventory.Refresh"), [=] { ... }));
+template <class TWork>
+auto InstrumentHop(const FHopTag& tag, TWork&& work)
+{
+	return [&tag, enqueued = FPlatformTime::Cycles64(), work = Forward<TWork>(work)]() mutable -> decltype(auto)
+	{
+		GPUTILS_HOP_SCOPE(tag, enqueued);
+		return work();
+	};
+}
+
+struct FHopStats
+{
+	FString tag;
+	uint64 count = 0;
+	double perSecond = 0;
+
+	// p50, p95 and p99 in milliseconds.
+	double waitMs[3] = {};
+	double runMs[3] = {};
+};
+
+// Histograms of all threads merged per tag, since the last reset. Tags without hops are left out.
+GPUTILS_API TArray<FHopStats> GetHopStats(bool reset = false);
+
+#else
+
+struct FHopTag
+{
+};
+
+#define GPUTILS_HOP_TAG(name) (FHopTag{})
+#define GPUTILS_HOP_SCOPE(tag, enqueued)
+
+template <class TWork>
+TWork&& InstrumentHop(const FHopTag&, TWork&& work)
+{
+	return Forward<TWork>(work);
+}
+
+#endif
@@ -74,7 +74,4 @@ private:
 	*/
 	UPROPERTY(BlueprintAssignable, Category = ImageLoader, meta = (AllowPrivateAccess = true))
 	FOnImageLoadCompleted LoadCompleted;
-
-	/** Holds the future value which represents the asynchronous loading operation. */
-	TFuture<UTexture2D*> Future;
 };
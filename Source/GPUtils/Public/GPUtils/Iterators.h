@@ -3,9 +3,13 @@
 #include <GPUtils/Types.h>
 
 #include <CoreMinimal.h>
+#include <Templates/IsIntegral.h>
+#include <Templates/IsSigned.h>
+
+#include <utility>
 
 template <class TType>
-FORCEINLINE TType ValidateType(TType value)
+FORCEINLINE constexpr TType ValidateType(TType value)
 {
     static_assert(TIsSame<decltype(value), TType>::Value, "Unexpected type");
     return value;
@@ -16,68 +20,86 @@ namespace Iterators
     template <class TValue, class TDerived>
     struct Base;
 
+    template <class TValue, class TDerived>
+    struct ConstBidirBase;
+
+    template <class TValue, class TDerived>
+    struct BidirBase;
+
     template <class TValue, class TDerived>
     struct ConstBase
     {
     public:
-        FORCEINLINE_DEBUGGABLE operator bool() const { return value.IsSet(); }
+        FORCEINLINE_DEBUGGABLE constexpr operator bool() const { return value.IsSet(); }
 
-        FORCEINLINE_DEBUGGABLE bool operator ==(const TDerived& other) const
+        FORCEINLINE_DEBUGGABLE constexpr bool operator ==(const TDerived& other) const
         {
             if (!AsDerieved() && !other) return true;
             if (!AsDerieved() || !other) return false;
             return AsDerieved().Equals(other);
         }
 
-        FORCEINLINE_DEBUGGABLE auto operator*() const { check(AsDerieved()); return AsDerieved().GetValue(); }
+        FORCEINLINE_DEBUGGABLE constexpr decltype(auto) operator*() const { GPUTILS_CHECK(AsDerieved()); return AsDerieved().GetValue(); }
 
-        template<class TValue2 = decltype(DeclVal<TDerived>().GetValue())>
-        FORCEINLINE_DEBUGGABLE Types::EnableIf<!Types::IsPointer<TValue2>, const TValue2*> operator->() const { check(AsDerieved()); return &AsDerieved().GetValue(); }
+        template<class TDerived2 = TDerived, class TValue2 = typename TDecay<decltype(DeclVal<TDerived2>().GetValue())>::Type>
+        FORCEINLINE_DEBUGGABLE constexpr Types::EnableIf<!Types::IsPointer<TValue2>, const TValue2*> operator->() const { GPUTILS_CHECK(AsDerieved()); return &AsDerieved().GetValue(); }
 
-        FORCEINLINE_DEBUGGABLE TDerived& operator++()
+        FORCEINLINE_DEBUGGABLE constexpr TDerived& operator++()
         {
-            check(AsDerieved());
-            value = ValidateType<TOptional<TValue>>(AsDerieved().ShiftForward());
+            GPUTILS_CHECK(AsDerieved());
+            value = ValidateType<Types::Optional<TValue>>(AsDerieved().ShiftForward());
             return AsDerieved();
         }
 
-        FORCEINLINE_DEBUGGABLE TDerived operator++(int)
+        FORCEINLINE_DEBUGGABLE constexpr TDerived operator++(int)
         {
-            check(AsDerieved());
+            GPUTILS_CHECK(AsDerieved());
             const auto ret = AsDerieved();
             ++(*this);
             return ret;
         }
 
-        FORCEINLINE_DEBUGGABLE TDerived operator+(std::size_t shift) const
+        // Templated so that it's preferred over the builtin addition through operator bool. Takes O(1) when the derived iterator can shift by several steps at once.
+        template <class TCount>
+        FORCEINLINE_DEBUGGABLE constexpr TDerived operator+(TCount shift) const
         {
-            check(AsDerieved());
-            const auto ret = AsDerieved();
-            for (auto i = 0; i < shift; ++i)
+            static_assert(TIsIntegral<TCount>::Value, "Iterators can only be shifted by an integral amount.");
+            if constexpr (TIsSigned<TCount>::Value)
+                GPUTILS_CHECK(shift >= 0);
+            GPUTILS_CHECK(AsDerieved());
+            auto ret = AsDerieved();
+            if constexpr (requires { ret.ShiftForward(static_cast<std::size_t>(shift)); })
+            {
+                static_cast<ConstBase&>(ret).value = ValidateType<Types::Optional<TValue>>(ret.ShiftForward(static_cast<std::size_t>(shift)));
+                return ret;
+            }
+            for (TCount i = 0; i < shift && ret; ++i)
                 ++ret;
             return ret;
         }
 
-        FORCEINLINE_DEBUGGABLE const TValue& GetValue() const
+        FORCEINLINE_DEBUGGABLE constexpr const TValue& GetValue() const
         {
             return value.GetValue();
         }
 
     protected:
-        ConstBase() = default;
-        FORCEINLINE_DEBUGGABLE ConstBase(TOptional<TValue>&& value_) : value(value_)
+        constexpr ConstBase() = default;
+        FORCEINLINE_DEBUGGABLE constexpr ConstBase(Types::Optional<TValue>&& value_) : value(std::move(value_))
         {
             if (!AsDerieved())
                 value.Reset();
         }
 
     private:
-        TOptional<TValue> value;
+        Types::Optional<TValue> value;
 
-        TDerived& AsDerieved() { return static_cast<TDerived&>(*this); }
-        const TDerived& AsDerieved() const { return static_cast<const TDerived&>(*this); }
+        constexpr TDerived& AsDerieved() { return static_cast<TDerived&>(*this); }
+        constexpr const TDerived& AsDerieved() const { return static_cast<const TDerived&>(*this); }
 
         friend struct Base<TValue, TDerived>;
+        friend struct ConstBidirBase<TValue, TDerived>;
+        friend struct BidirBase<TValue, TDerived>;
     };
 
     template <class TValue, class TDerived>
@@ -87,23 +109,23 @@ namespace Iterators
         using TBase = ConstBase<TValue, TDerived>;
 
     public:
-        FORCEINLINE_DEBUGGABLE TValue& operator*() { check(AsDerieved()); return GetValue(); }
+        FORCEINLINE_DEBUGGABLE constexpr TValue& operator*() { GPUTILS_CHECK(AsDerieved()); return GetValue(); }
 
-        template<class TValue2 = decltype(DeclVal<TDerived>().GetValue())>
-        FORCEINLINE_DEBUGGABLE Types::EnableIf<!Types::IsPointer<TValue2>, TValue*> operator->() { check(AsDerieved()); return &AsDerieved().GetValue(); }
+        template<class TDerived2 = TDerived, class TValue2 = decltype(DeclVal<TDerived2>().GetValue())>
+        FORCEINLINE_DEBUGGABLE constexpr Types::EnableIf<!Types::IsPointer<TValue2>, TValue*> operator->() { GPUTILS_CHECK(AsDerieved()); return &AsDerieved().GetValue(); }
 
-        FORCEINLINE_DEBUGGABLE TValue& GetValue()
+        FORCEINLINE_DEBUGGABLE constexpr TValue& GetValue()
         {
-            return value.GetValue();
+            return this->value.GetValue();
         }
 
     protected:
-        Base() = default;
-        FORCEINLINE_DEBUGGABLE Base(TOptional<TValue>&& value_) : TBase(MoveTemp(value_)) {}
+        constexpr Base() = default;
+        FORCEINLINE_DEBUGGABLE constexpr Base(Types::Optional<TValue>&& value_) : TBase(std::move(value_)) {}
 
     private:
-        TDerived& AsDerieved() { return *reinterpret_cast<TDerived*>(this); }
-        const TDerived& AsDerieved() const { return *reinterpret_cast<const TDerived*>(this); }
+        constexpr TDerived& AsDerieved() { return static_cast<TDerived&>(*this); }
+        constexpr const TDerived& AsDerieved() const { return static_cast<const TDerived&>(*this); }
     };
 
     template <class TValue, class TDerived>
@@ -113,58 +135,58 @@ namespace Iterators
         using Base = ConstBase<TValue, TDerived>;
 
     public:
-        FORCEINLINE_DEBUGGABLE TDerived& operator--()
+        FORCEINLINE_DEBUGGABLE constexpr TDerived& operator--()
         {
-            check(AsDerieved());
-            value = ValidateType<TOptional<TValue>>(AsDerieved().ShiftBack());
+            GPUTILS_CHECK(AsDerieved());
+            this->value = ValidateType<Types::Optional<TValue>>(AsDerieved().ShiftBack());
             return AsDerieved();
         }
 
-        FORCEINLINE_DEBUGGABLE TDerived operator--(int)
+        FORCEINLINE_DEBUGGABLE constexpr TDerived operator--(int)
         {
-            check(AsDerieved());
+            GPUTILS_CHECK(AsDerieved());
             const auto ret = AsDerieved();
             --(*this);
             return ret;
         }
 
     protected:
-        ConstBidirBase() = default;
-        FORCEINLINE_DEBUGGABLE ConstBidirBase(TOptional<TValue>&& value_) : Base(MoveTemp(value_)) {}
+        constexpr ConstBidirBase() = default;
+        FORCEINLINE_DEBUGGABLE constexpr ConstBidirBase(Types::Optional<TValue>&& value_) : Base(std::move(value_)) {}
 
     private:
-        TDerived& AsDerieved() { return *reinterpret_cast<TDerived*>(this); }
-        const TDerived& AsDerieved() const { return *reinterpret_cast<const TDerived*>(this); }
+        constexpr TDerived& AsDerieved() { return static_cast<TDerived&>(*this); }
+        constexpr const TDerived& AsDerieved() const { return static_cast<const TDerived&>(*this); }
     };
 
     template <class TValue, class TDerived>
     struct BidirBase : Base<TValue, TDerived>
     {
     private:
-        using TBase = ConstBase<TValue, TDerived>;
+        using TBase = Base<TValue, TDerived>;
 
     public:
-        FORCEINLINE_DEBUGGABLE TDerived& operator--()
+        FORCEINLINE_DEBUGGABLE constexpr TDerived& operator--()
         {
-            check(AsDerieved());
-            value = ValidateType<TOptional<TValue>>(AsDerieved().ShiftBack());
+            GPUTILS_CHECK(AsDerieved());
+            this->value = ValidateType<Types::Optional<TValue>>(AsDerieved().ShiftBack());
             return AsDerieved();
         }
 
-        FORCEINLINE_DEBUGGABLE TDerived operator--(int)
+        FORCEINLINE_DEBUGGABLE constexpr TDerived operator--(int)
         {
-            check(AsDerieved());
+            GPUTILS_CHECK(AsDerieved());
             const auto ret = AsDerieved();
             --(*this);
             return ret;
         }
 
     protected:
-        BidirBase() = default;
-        FORCEINLINE_DEBUGGABLE BidirBase(TOptional<TValue>&& value_) : TBase(MoveTemp(value_)) {}
+        constexpr BidirBase() = default;
+        FORCEINLINE_DEBUGGABLE constexpr BidirBase(Types::Optional<TValue>&& value_) : TBase(std::move(value_)) {}
 
     private:
-        TDerived& AsDerieved() { return *reinterpret_cast<TDerived*>(this); }
-        const TDerived& AsDerieved() const { return *reinterpret_cast<const TDerived*>(this); }
+        constexpr TDerived& AsDerieved() { return static_cast<TDerived&>(*this); }
+        constexpr const TDerived& AsDerieved() const { return static_cast<const TDerived&>(*this); }
     };
 }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+enum class EJobPriority : uint8
+{
+	High,    // Results the player is waiting for, e.g. a visible thumbnail.
+	Normal,
+	Low,     // Speculative work, e.g. prefetching.
+	Num,
+};
+
+class FJob;
+
+using FJobHandle = TSharedPtr<FJob, ESPMode::ThreadSafe>;
+
+// Queues work on the GPUtils job workers. Every worker owns a deque per priority: jobs launched from a worker go to its own deque and run newest first,
+// idle workers steal the oldest jobs of busy ones. Higher priorities are taken first, from the own deque or by stealing, before any lower priority job.
+// With a parent, the parent only counts as done once the child is, so a job can fan out into subjobs and be waited on as a whole:
+// LaunchJob([=] { for (auto mip : mips) LaunchJob([=] { Compress(mip); }, EJobPriority::High, GetCurrentJob()); }, EJobPriority::High);
+// The parent must not be done yet, so children are launched from its work or from the work of another of its children.
+GPUTILS_API FJobHandle LaunchJob(TUniqueFunction<void()>&& work, EJobPriority priority = EJobPriority::Normal, const FJobHandle& parent = nullptr);
+
+// The job executing on the calling thread, nullptr outside of jobs.
+GPUTILS_API const FJobHandle& GetCurrentJob();
+
+// Whether the job and all of its children have finished.
+GPUTILS_API bool IsJobDone(const FJobHandle& job);
+
+// Blocks until the job and all of its children have finished, executing other queued jobs meanwhile.
+GPUTILS_API void WaitForJob(const FJobHandle& job);
+
+struct FJobStats
+{
+	// Workers running jobs, see SetJobWorkerLimit.
+	int32 workers = 0;
+	int32 queued = 0;
+	uint64 executed = 0;
+	uint64 steals = 0;
+	double idleMs = 0;
+};
+
+// Counters since the last reset, summed over the workers. Jobs executed by waiting threads count as executed, not as steals.
+GPUTILS_API FJobStats GetJobStats(bool reset = false);
+
+// Limits the workers that run jobs, e.g. to measure how a workload scales. 0 or more than there are uses all of them.
+GPUTILS_API void SetJobWorkerLimit(int32 num);
+
+// Stops the workers, then runs the jobs still queued on the calling thread so that their parents complete. Called by the module on shutdown,
+// later launches run inline.
+GPUTILS_API void ShutdownJobs();
@@ -1,32 +1,42 @@
 #pragma once
 
-#include <Algo/Accumulate.h>
+#include <GPUtils/PlayerControllerRegistry.h>
+
 #include <CoreMinimal.h>
 #include <Engine/World.h>
 
+class APlayerController;
 class UWorld;
 
+// Player controllers of the world, read from UPlayerControllerRegistry: no weak pointer resolution per element and O(1) Num.
+// Like any TArray loop, don't spawn or destroy controllers while iterating. Elements are plain pointers, they used to be TWeakObjectPtrs:
+// callers that went through .Get() or IsValid() on them use the pointer directly now. Worlds without the registry (inactive and editor preview
+// worlds, or no world at all) have no controllers.
 class PlayerControllerRange
 {
 public:
-	using Element = TWeakObjectPtr<APlayerController>;
+	using Element = APlayerController*;
 
-	PlayerControllerRange(UWorld* world_)
-		: world(world_)
+	PlayerControllerRange(UWorld* world)
+		: registry(world != nullptr ? world->GetSubsystem<UPlayerControllerRegistry>() : nullptr)
 	{
+		if (registry != nullptr)
+			registry->Refresh();
 	}
 
-	FORCEINLINE_DEBUGGABLE auto begin() const { return world->GetPlayerControllerIterator(); }
+	FORCEINLINE_DEBUGGABLE auto begin() const { return GetControllers().begin(); }
+	FORCEINLINE_DEBUGGABLE auto end() const { return GetControllers().end(); }
 
-	FORCEINLINE_DEBUGGABLE auto end() const
-	{
-		auto ret = world->GetPlayerControllerIterator();
-		ret.SetToEnd();
-		return ret;
-	}
+	FORCEINLINE_DEBUGGABLE int32 Num() const { return GetControllers().Num(); }
 
-	FORCEINLINE_DEBUGGABLE auto Num() const { return Algo::Accumulate(*this, 0, [](auto v, auto p) { return v + 1; }); }
+	FORCEINLINE_DEBUGGABLE APlayerController* GetFirstLocal() const { return registry != nullptr ? registry->GetFirstLocalController() : nullptr; }
 
 private:
-	UWorld* world;
+	UPlayerControllerRegistry* registry;
+
+	FORCEINLINE_DEBUGGABLE const TArray<APlayerController*>& GetControllers() const
+	{
+		static const TArray<APlayerController*> none;
+		return registry != nullptr ? registry->GetControllers() : none;
+	}
 };
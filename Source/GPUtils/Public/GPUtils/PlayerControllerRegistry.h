@@ -0,0 +1,45 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Engine/EngineTypes.h>
+#include <Subsystems/WorldSubsystem.h>
+
+#include "PlayerControllerRegistry.generated.h"
+
+class AActor;
+class APlayerController;
+
+// Strong, contiguous list of the player controllers of a world in spawn order, kept up to date from spawn and end play events.
+// Works the same on servers and clients, since it doesn't depend on login events. Controllers that arrive without being spawned (seamless travel)
+// are picked up by Refresh, which PlayerControllerRange calls whenever the count differs from the world's own list.
+UCLASS()
+class GPUTILS_API UPlayerControllerRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	FORCEINLINE_DEBUGGABLE const TArray<APlayerController*>& GetControllers() const { return controllers; }
+
+	// O(1) unless the registry is out of sync with the world, then rebuilds it from the world's controller list.
+	void Refresh();
+
+	// First controller owned by a local player. Locality is only known once a player is assigned, so misses are resolved by a scan and hits are cached.
+	APlayerController* GetFirstLocalController() const;
+
+private:
+	UPROPERTY()
+	TArray<APlayerController*> controllers;
+
+	UPROPERTY()
+	mutable APlayerController* firstLocal = nullptr;
+
+	FDelegateHandle actorSpawned;
+
+	void OnActorSpawned(AActor* actor);
+
+	UFUNCTION()
+	void OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason);
+};
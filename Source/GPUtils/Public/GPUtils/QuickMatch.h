@@ -0,0 +1,173 @@
+#pragma once
+
+#include <GPUtils/SessionCache.h>
+#include <GPUtils/Sessions.h>
+
+#include <Async/Future.h>
+#include <CoreMinimal.h>
+#include <HAL/Runnable.h>
+
+#include <atomic>
+
+#include "QuickMatch.generated.h"
+
+// Measures the round trip time to the host of a session, given its resolved connect string. Called on the game thread, the future may complete on
+// any thread, with INDEX_NONE when the host didn't answer. Injected into quick-match, so that tests can stand in a local echo service for hosts.
+class GPUTILS_API ISessionProbe
+{
+public:
+	virtual ~ISessionProbe() = default;
+
+	virtual TFuture<int32> Probe(const FString& connectString) = 0;
+};
+
+class FRunnableThread;
+class FSocket;
+
+// Sends a datagram per probe to a UDP echo service on the hosts. All probes share one non-blocking socket, created with the first one, and one
+// thread that waits for the replies of every probe in flight and times them out. Destroying it reports the probes in flight as unanswered.
+class GPUTILS_API FUdpEchoProbe final : public ISessionProbe, private FRunnable
+{
+public:
+	// Port 0 probes the port of the connect string itself.
+	explicit FUdpEchoProbe(int32 port_ = 0, float timeoutSeconds_ = 1.f) : port(port_), timeoutSeconds(timeoutSeconds_) {}
+	virtual ~FUdpEchoProbe() override;
+
+	virtual TFuture<int32> Probe(const FString& connectString) override;
+
+private:
+	struct FPending
+	{
+		uint64 sent = 0;
+		double deadline = 0;
+		TPromise<int32> promise;
+	};
+
+	int32 port;
+	float timeoutSeconds;
+
+	FSocket* socket = nullptr;
+	FRunnableThread* thread = nullptr;
+	std::atomic<bool> stopping{ false };
+
+	// Keyed by the token the datagram carries, so that replies to probes that timed out aren't mistaken for later ones.
+	FCriticalSection lock;
+	TMap<uint64, FPending> pending;
+	uint64 nextToken = 0;
+
+	virtual uint32 Run() override;
+	virtual void Stop() override { stopping = true; }
+
+	void Receive();
+	void Expire();
+};
+
+UENUM(BlueprintType)
+enum class EQuickMatchResult : uint8
+{
+	Success,
+	InvalidPlayer,
+	FailedToFindSessions,
+	NoSessionFound,
+	FailedToJoinSession,
+	InvalidWorldContext,
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FQuickMatchResultHandler, EQuickMatchResult, status);
+
+USTRUCT(BlueprintType)
+struct FQuickMatchSettings
+{
+	GENERATED_BODY()
+
+	// Sessions with the lowest subsystem ping that are probed and tried, full ones are skipped.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 maxCandidates = 8;
+
+	// Port of a UDP echo service on the hosts. 0 ranks by the ping the subsystem reports instead of probing.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 echoPort = 0;
+
+	// Hosts that don't answer in time are ranked as if their round trip took this long.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float probeTimeoutSeconds = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString preferredMap;
+
+	// Milliseconds of round trip a full session is worth over an empty one, so that players end up together.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float fillWeight = 50.f;
+
+	// Milliseconds of round trip a session on the preferred map is worth.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float mapBonus = 100.f;
+};
+
+// Finds sessions, probes the best candidates in parallel, then joins the one with the lowest score: round trip minus the fill and map bonuses.
+// When a join fails because the session filled up or went away, the session it left behind is destroyed and the next candidate is joined without
+// searching again. The task is rooted until it reports, it and the tasks it started can't be garbage collected meanwhile.
+UCLASS(BlueprintType)
+class GPUTILS_API UQuickMatchTask : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "worldContext", HidePin = "worldContext"))
+	static UQuickMatchTask* QuickMatchAsync(UObject* worldContext, ULocalPlayer* player, const FSessionQuery& query, const FQuickMatchSettings& settings, FQuickMatchResultHandler callback);
+
+	// Probes with the given transport, nullptr ranks by the subsystem's ping.
+	static UQuickMatchTask* QuickMatchAsync(UObject* worldContext, ULocalPlayer* player, const FSessionQuery& query, const FQuickMatchSettings& settings, TSharedPtr<ISessionProbe> probe, FQuickMatchResultHandler callback);
+
+	// Session being joined, or the one joined once the task succeeded.
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	FSessionResult GetSession() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	UFindSessionsTask* GetSearch() const { return search; }
+
+private:
+	struct FCandidate
+	{
+		int32 id = 0;
+		int32 rtt = INDEX_NONE;
+		float score = 0;
+	};
+
+	UPROPERTY()
+	UFindSessionsTask* search = nullptr;
+
+	// In flight, the session tasks aren't referenced by anything else.
+	UPROPERTY()
+	UJoinSessionTask* joining = nullptr;
+
+	UPROPERTY()
+	UDestroySessionTask* destroying = nullptr;
+
+	TWeakObjectPtr<UObject> worldContext;
+	TWeakObjectPtr<ULocalPlayer> player;
+	FQuickMatchSettings settings;
+	TSharedPtr<ISessionProbe> probe;
+	FQuickMatchResultHandler callback;
+
+	TArray<FCandidate> candidates;
+	int32 probing = 0;
+	int32 attempt = 0;
+
+	UFUNCTION()
+	void OnSearchComplete(EFindSessionsResult status);
+
+	void OnProbed(int32 index, int32 rtt);
+
+	// Joins the best candidate not tried yet.
+	void JoinNext();
+
+	UFUNCTION()
+	void OnJoinComplete(EJoinSessionResult status);
+
+	UFUNCTION()
+	void OnSessionDestroyed(EDestroySessionResult status);
+
+	// Unroots the task and reports the result.
+	void Finish(EQuickMatchResult result);
+};
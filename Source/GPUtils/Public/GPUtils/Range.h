@@ -4,76 +4,250 @@
 #include <GPUtils/Iterators.h>
 
 #include <CoreMinimal.h>
+#include <Templates/IsSigned.h>
 
 namespace Range
 {
+    template <class TType>
+    constexpr bool IsRange = false;
+
+    // Ranges over a contiguous block of memory, they expose GetData() and Num().
+    template <class TType>
+    constexpr bool IsContiguous = false;
+
+    namespace Detail
+    {
+        // Walking distance from `from` to `to`, unset when `to` lies behind `from`.
+        template <class TValue>
+        FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<TValue> Distance(TValue from, TValue to, bool descending)
+        {
+            if (descending ? from < to : to < from)
+                return {};
+            return static_cast<TValue>(descending ? from - to : to - from);
+        }
+
+        template <class TValue>
+        FORCEINLINE_DEBUGGABLE constexpr int32 Num(TValue from, TValue to, TValue step, bool descending)
+        {
+            const auto distance = Distance(from, to, descending);
+            return distance ? static_cast<int32>(distance.GetValue() / step) + 1 : 0;
+        }
+
+        // Moves value by count steps towards limit, unset if that would pass the limit. Never overflows TValue.
+        template <class TValue>
+        FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<TValue> Shift(TValue value, TValue limit, TValue step, bool descending, std::size_t count)
+        {
+            const auto distance = Distance(value, limit, descending);
+            if (!distance || static_cast<std::size_t>(distance.GetValue() / step) < count)
+                return {};
+            const auto offset = static_cast<TValue>(step * count);
+            return static_cast<TValue>(descending ? value - offset : value + offset);
+        }
+    }
+
     namespace Types
     {
-        template <class TValue, TValue delta = 1>
+        // Inclusive arithmetic range with a compile-time step. Negative steps walk from `from` down to `to`.
+        template <class TValue, TValue delta = static_cast<TValue>(1)>
         struct Range
         {
         private:
+            static_assert(delta != 0, "Range step can't be zero.");
+            static constexpr bool descending = delta < 0;
+            static constexpr TValue step = descending ? static_cast<TValue>(-delta) : delta;
+
             struct IteratorCtorLocker {};
 
         public:
             using Value = TValue;
 
-            struct ConstIterator : Iterators::ConstBase<Value, ConstIterator>
+            struct ConstIterator : Iterators::ConstBidirBase<Value, ConstIterator>
             {
             private:
-                using Base = Iterators::ConstBase<Value, ConstIterator>;
-                friend struct Base;
+                using Base = Iterators::ConstBidirBase<Value, ConstIterator>;
+                friend Iterators::ConstBase<Value, ConstIterator>;
+                friend Base;
 
             public:
-                FORCEINLINE_DEBUGGABLE ConstIterator() = default;
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
 
-                FORCEINLINE_DEBUGGABLE ConstIterator(IteratorCtorLocker, Value from, Value to_)
-                    : Base((from <= to) ? MoveTemp(from) : TOptional<Value>{})
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, Value from_, Value to_, Value at)
+                    : Base(Detail::Distance(from_, to_, descending) ? ::Types::Optional<Value>{ at } : ::Types::Optional<Value>{})
+                    , from(from_)
                     , to(to_)
                 {
                 }
 
             protected:
-                FORCEINLINE_DEBUGGABLE bool Equals(const ConstIterator& other) const
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
                 {
-                    check(this->to == other.to);
+                    GPUTILS_CHECK(this->from == other.from && this->to == other.to);
                     return this->GetValue() == other.GetValue();
                 }
 
-                FORCEINLINE_DEBUGGABLE TOptional<Value> ShiftForward()
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<Value> ShiftForward(std::size_t count = 1) { return Detail::Shift(this->GetValue(), to, step, descending, count); }
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<Value> ShiftBack() { return Detail::Shift(this->GetValue(), from, step, !descending, 1); }
+
+                Value from{};
+                Value to{};
+            };
+
+            FORCEINLINE_DEBUGGABLE constexpr Range(Value from_, Value to_) : from(from_), to(to_) {}
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, from, to, from, }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return {}; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator Last() const { return Num() > 0 ? begin() + (Num() - 1) : end(); }
+
+            FORCEINLINE_DEBUGGABLE constexpr int32 Num() const { return Detail::Num(from, to, step, descending); }
+
+            FORCEINLINE_DEBUGGABLE constexpr const Value& GetFrom() const { return from; }
+            FORCEINLINE_DEBUGGABLE constexpr const Value& GetTo() const { return to; }
+
+        private:
+            Value from;
+            Value to;
+        };
+
+        // Inclusive arithmetic range with a runtime step, see Range::Make(from, to, step).
+        template <class TValue>
+        struct Stepped
+        {
+        private:
+            struct IteratorCtorLocker {};
+
+        public:
+            using Value = TValue;
+
+            struct ConstIterator : Iterators::ConstBidirBase<Value, ConstIterator>
+            {
+            private:
+                using Base = Iterators::ConstBidirBase<Value, ConstIterator>;
+                friend Iterators::ConstBase<Value, ConstIterator>;
+                friend Base;
+
+            public:
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
+
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, Value from_, Value to_, Value step_, bool descending_, Value at)
+                    : Base(Detail::Distance(from_, to_, descending_) ? ::Types::Optional<Value>{ at } : ::Types::Optional<Value>{})
+                    , from(from_)
+                    , to(to_)
+                    , step(step_)
+                    , descending(descending_)
+                {
+                }
+
+            protected:
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
                 {
-                    auto v = GetValue();
-                    v += delta;
-                    if (v > to)
-                        return {};
-                    return v;
+                    GPUTILS_CHECK(this->from == other.from && this->to == other.to && this->step == other.step);
+                    return this->GetValue() == other.GetValue();
                 }
 
-                Value to;
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<Value> ShiftForward(std::size_t count = 1) { return Detail::Shift(this->GetValue(), to, step, descending, count); }
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<Value> ShiftBack() { return Detail::Shift(this->GetValue(), from, step, !descending, 1); }
+
+                Value from{};
+                Value to{};
+                Value step{};
+                bool descending = false;
             };
 
-            FORCEINLINE_DEBUGGABLE Range(Value from_, Value to_) : from(from_), to(to_) {}
-            FORCEINLINE_DEBUGGABLE ConstIterator begin() const { return { IteratorCtorLocker{}, from, to, }; }
-            FORCEINLINE_DEBUGGABLE ConstIterator end() const { return {}; }
+            FORCEINLINE_DEBUGGABLE constexpr Stepped(Value from_, Value to_, Value step_, bool descending_) : from(from_), to(to_), step(step_), descending(descending_) { GPUTILS_CHECK(step > 0); }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, from, to, step, descending, from, }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return {}; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator Last() const { return Num() > 0 ? begin() + (Num() - 1) : end(); }
+
+            FORCEINLINE_DEBUGGABLE constexpr int32 Num() const { return Detail::Num(from, to, step, descending); }
 
         private:
             Value from;
             Value to;
+            Value step;
+            bool descending;
+        };
+
+        // Walks a range from its last element to its first one. The range has to provide Last() and bidirectional iterators.
+        template <class TRange>
+        struct Reversed
+        {
+        private:
+            struct IteratorCtorLocker {};
+            using InnerIterator = typename TRange::ConstIterator;
+
+        public:
+            using Value = typename TRange::Value;
+
+            struct ConstIterator : Iterators::ConstBidirBase<InnerIterator, ConstIterator>
+            {
+            private:
+                using Base = Iterators::ConstBidirBase<InnerIterator, ConstIterator>;
+                friend Iterators::ConstBase<InnerIterator, ConstIterator>;
+                friend Base;
+
+            public:
+                FORCEINLINE_DEBUGGABLE constexpr operator bool() const { return static_cast<const Base&>(*this) && Base::GetValue(); }
+
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
+
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, InnerIterator&& iterator)
+                    : Base(std::move(iterator))
+                {
+                }
+
+            protected:
+                FORCEINLINE_DEBUGGABLE constexpr Value GetValue() const
+                {
+                    GPUTILS_CHECK(*this);
+                    return *Base::GetValue();
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
+                {
+                    return Base::GetValue() == static_cast<const Base&>(other).GetValue();
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<InnerIterator> ShiftForward()
+                {
+                    auto v = Base::GetValue();
+                    if (!--v)
+                        return {};
+                    return v;
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<InnerIterator> ShiftBack()
+                {
+                    auto v = Base::GetValue();
+                    if (!++v)
+                        return {};
+                    return v;
+                }
+            };
+
+            FORCEINLINE_DEBUGGABLE constexpr Reversed(TRange range_) : range(std::move(range_)) {}
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, range.Last(), }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return {}; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator Last() const { return { IteratorCtorLocker{}, range.begin(), }; }
+
+            template <bool sized = ::Types::HasNum<TRange>>
+            FORCEINLINE_DEBUGGABLE constexpr ::Types::EnableIf<sized, int32> Num() const { return range.Num(); }
+
+        private:
+            TRange range;
         };
 
         template <class TTuple, std::size_t index = Algo::TupleSize<TTuple> - 1>
         struct IteratorTupleIncrement
         {
-            IteratorTupleIncrement(const TTuple& start_)
+            constexpr IteratorTupleIncrement(const TTuple& start_)
                 : start(start_)
             {
             }
 
-            TTuple& operator()(TTuple& value) const
+            constexpr TTuple& operator()(TTuple& value) const
             {
-                if (++value.Get<index>())
+                if (++value.template Get<index>())
                     return value;
-                value.Get<index>() = start.Get<index>();
+                value.template Get<index>() = start.template Get<index>();
                 return IteratorTupleIncrement<TTuple, index - 1>{ start }(value);
             }
 
@@ -84,11 +258,11 @@ namespace Range
         template <class TTuple>
         struct IteratorTupleIncrement<TTuple, 0>
         {
-            IteratorTupleIncrement(const TTuple&) {}
+            constexpr IteratorTupleIncrement(const TTuple&) {}
 
-            TTuple& operator()(TTuple& value) const
+            constexpr TTuple& operator()(TTuple& value) const
             {
-                ++value.Get<0>();
+                ++value.template Get<0>();
                 return value;
             }
         };
@@ -98,7 +272,7 @@ namespace Range
         {
         private:
             using InnerIteratorPack = TTuple<typename TRanges::ConstIterator...>;
-            using EndIterator = decltype(DeclVal<InnerIteratorPack>().Get<0>());
+            using EndIterator = typename TDecay<decltype(DeclVal<InnerIteratorPack>().template Get<0>())>::Type;
             struct IteratorCtorLocker {};
 
         public:
@@ -108,36 +282,36 @@ namespace Range
             {
             private:
                 using Base = Iterators::ConstBase<InnerIteratorPack, ConstIterator>;
-                friend struct Base;
+                friend Base;
 
             public:
-                FORCEINLINE_DEBUGGABLE operator bool() const { return ((Base&)*this) && Base::GetValue().ApplyBefore([](auto... iterators) { return (... && iterators); }); }
+                FORCEINLINE_DEBUGGABLE constexpr operator bool() const { return static_cast<const Base&>(*this) && Base::GetValue().ApplyBefore([](const auto&... iterators) { return (... && iterators); }); }
 
-                FORCEINLINE_DEBUGGABLE ConstIterator() = default;
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
 
-                FORCEINLINE_DEBUGGABLE ConstIterator(IteratorCtorLocker, InnerIteratorPack from, InnerIteratorPack start_, InnerIteratorPack end_)
-                    : Base(MoveTemp(from))
-                    , start(MoveTemp(start_))
-                    , end(end_.Get<0>())
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, InnerIteratorPack from, InnerIteratorPack start_, InnerIteratorPack end_)
+                    : Base(std::move(from))
+                    , start(std::move(start_))
+                    , end(end_.template Get<0>())
                 {
                 }
 
             protected:
-                FORCEINLINE_DEBUGGABLE Value GetValue() const
+                FORCEINLINE_DEBUGGABLE constexpr Value GetValue() const
                 {
-                    check(*this);
-                    return Base::GetValue().ApplyBefore([](auto... elements) { return MakeTuple(*elements...); });
+                    GPUTILS_CHECK(*this);
+                    return Base::GetValue().ApplyBefore([](const auto&... elements) { return MakeTuple(*elements...); });
                 }
 
-                FORCEINLINE_DEBUGGABLE bool Equals(const ConstIterator& other) const
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
                 {
-                    return Base::GetValue() == ((Base&)other).GetValue();
+                    return Base::GetValue() == static_cast<const Base&>(other).GetValue();
                 }
 
-                FORCEINLINE_DEBUGGABLE TOptional<InnerIteratorPack> ShiftForward()
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<InnerIteratorPack> ShiftForward()
                 {
                     auto v = Base::GetValue();
-                    if (IteratorTupleIncrement<InnerIteratorPack>(start)(v).Get<0>() == end)
+                    if (IteratorTupleIncrement<InnerIteratorPack>(start)(v).template Get<0>() == end)
                         return {};
                     return v;
                 }
@@ -146,16 +320,22 @@ namespace Range
                 EndIterator end;
             };
 
-            FORCEINLINE_DEBUGGABLE Join(const TRanges&... ranges) : from(ranges.begin()...), to(ranges.end()...) {}
-            FORCEINLINE_DEBUGGABLE ConstIterator begin() const { return { IteratorCtorLocker{}, from, from, to, }; }
-            FORCEINLINE_DEBUGGABLE ConstIterator end() const { return { IteratorCtorLocker{}, to, from, to, }; }
+            FORCEINLINE_DEBUGGABLE constexpr Join(const TRanges&... ranges_) : ranges(ranges_...), from(ranges_.begin()...), to(ranges_.end()...) {}
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, from, from, to, }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return { IteratorCtorLocker{}, to, from, to, }; }
+
+            template <bool sized = (::Types::HasNum<TRanges> && ...)>
+            FORCEINLINE_DEBUGGABLE constexpr ::Types::EnableIf<sized, int32> Num() const { return ranges.ApplyBefore([](const auto&... r) { return (1 * ... * r.Num()); }); }
+
+            FORCEINLINE_DEBUGGABLE constexpr const TTuple<TRanges...>& GetRanges() const { return ranges; }
 
         private:
+            TTuple<TRanges...> ranges;
             InnerIteratorPack from;
             InnerIteratorPack to;
         };
 
-        template <class TRange, class TTo>
+        template <class TRange, class TTo, class TFunctor = TFunction<TTo(const typename TRange::Value&)>>
         struct Map
         {
         private:
@@ -163,39 +343,39 @@ namespace Range
             using InnerIterator = typename TRange::ConstIterator;
 
         public:
-            using Value = typename TTo;
-            using Functor = TFunction<TTo(const typename TRange::Value&)>;
+            using Value = TTo;
+            using Functor = TFunctor;
 
             struct ConstIterator : Iterators::ConstBase<InnerIterator, ConstIterator>
             {
             private:
                 using Base = Iterators::ConstBase<InnerIterator, ConstIterator>;
-                friend struct Base;
+                friend Base;
 
             public:
-                FORCEINLINE_DEBUGGABLE operator bool() const { return ((Base&)*this) && Base::GetValue(); }
+                FORCEINLINE_DEBUGGABLE constexpr operator bool() const { return static_cast<const Base&>(*this) && Base::GetValue(); }
 
-                FORCEINLINE_DEBUGGABLE ConstIterator() = default;
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
 
-                FORCEINLINE_DEBUGGABLE ConstIterator(IteratorCtorLocker, InnerIterator&& iterator, Functor functor_)
-                    : Base(MoveTemp(iterator))
-                    , functor(MoveTemp(functor_))
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, InnerIterator&& iterator, const Functor& functor_)
+                    : Base(std::move(iterator))
+                    , functor(functor_)
                 {
                 }
 
             protected:
-                TTo GetValue() const
+                constexpr TTo GetValue() const
                 {
-                    check(*this);
-                    return functor(*Base::GetValue());
+                    GPUTILS_CHECK(*this);
+                    return functor.GetValue()(*Base::GetValue());
                 }
 
-                FORCEINLINE_DEBUGGABLE bool Equals(const ConstIterator& other) const
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
                 {
-                    return Base::GetValue() == ((Base&)other).GetValue();
+                    return Base::GetValue() == static_cast<const Base&>(other).GetValue();
                 }
 
-                FORCEINLINE_DEBUGGABLE TOptional<InnerIterator> ShiftForward()
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<InnerIterator> ShiftForward()
                 {
                     auto v = Base::GetValue();
                     if (!++v)
@@ -203,12 +383,15 @@ namespace Range
                     return v;
                 }
 
-                Functor functor;
+                ::Types::Optional<Functor> functor;
             };
 
-            FORCEINLINE_DEBUGGABLE Map(TRange range_, Functor functor_) : range(MoveTemp(range_)), functor(MoveTemp(functor_)) {}
-            FORCEINLINE_DEBUGGABLE ConstIterator begin() const { return { IteratorCtorLocker{}, range.begin(), functor, }; }
-            FORCEINLINE_DEBUGGABLE ConstIterator end() const { return { IteratorCtorLocker{}, range.end(), functor, }; }
+            FORCEINLINE_DEBUGGABLE constexpr Map(TRange range_, Functor functor_) : range(std::move(range_)), functor(std::move(functor_)) {}
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, range.begin(), functor, }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return { IteratorCtorLocker{}, range.end(), functor, }; }
+
+            template <bool sized = ::Types::HasNum<TRange>>
+            FORCEINLINE_DEBUGGABLE constexpr ::Types::EnableIf<sized, int32> Num() const { return range.Num(); }
 
         private:
             TRange range;
@@ -216,43 +399,55 @@ namespace Range
         };
     }
 
-    template <class TValue, TValue delta = 1>
-    auto Make(TValue from, TValue to) { return Types::Range<TValue>{ from, to, }; }
+    template <class TValue, TValue delta = static_cast<TValue>(1)>
+    constexpr auto Make(TValue from, TValue to) { return Types::Range<TValue, delta>{ from, to, }; }
 
-    template <class TValue, TValue delta = 1, class TSource>
-    auto Indexes(const TSource& source) { return Types::Range<TValue>{ 0, source.Num() - 1, }; }
+    template <class TValue, class TStep>
+    constexpr auto Make(TValue from, TValue to, TStep step)
+    {
+        GPUTILS_CHECK(step != 0);
+        if constexpr (TIsSigned<TStep>::Value)
+        {
+            if (step < 0)
+                return Types::Stepped<TValue>{ from, to, static_cast<TValue>(-step), true, };
+        }
+        return Types::Stepped<TValue>{ from, to, static_cast<TValue>(step), false, };
+    }
 
-    template <class... TRanges>
-    auto Join(TRanges... ranges) { return Types::Join<TRanges...>{ ranges... }; }
-}
+    template <class TValue, TValue delta = static_cast<TValue>(1), class TSource>
+    constexpr auto Indexes(const TSource& source)
+    {
+        using Result = Types::Range<TValue, delta>;
+        const auto num = static_cast<TValue>(source.Num());
+        if (num == 0)
+            return (delta > 0) ? Result{ 1, 0, } : Result{ 0, 1, };
+        return (delta > 0) ? Result{ 0, static_cast<TValue>(num - 1), } : Result{ static_cast<TValue>(num - 1), 0, };
+    }
 
-#define MakeJoinOperator(TLeft, TRight, ...) \
-template<__VA_ARGS__> \
-FORCEINLINE auto operator*(TLeft left, TRight right) { return Range::Types::Join<TLeft, TRight>{ left, right, }; }
+    template <class... TRanges>
+    constexpr auto Join(TRanges... ranges) { return Types::Join<TRanges...>{ ranges... }; }
 
-#define MakeMapOperator(TRange, ...) \
-template<class TFunctor, __VA_ARGS__> \
-FORCEINLINE auto operator|(TRange left, TFunctor right) { return Range::Types::Map<TRange, decltype(right(*left.begin()))>{ left, right, }; }
+    template <class TRange>
+    constexpr auto Reverse(TRange range) { return Types::Reversed<TRange>{ std::move(range), }; }
 
-#define X(...) __VA_ARGS__
+    template <class TValue, TValue delta>
+    constexpr bool IsRange<Types::Range<TValue, delta>> = true;
 
-MakeJoinOperator(X(Range::Types::Range<TLeft, lDelta>), X(Range::Types::Range<TRight, rDelta>), class TLeft, TLeft lDelta, class TRight, TRight rDelta)
-MakeJoinOperator(X(Range::Types::Join<TLeft...>), X(Range::Types::Join<TRight...>), class... TLeft, class... TRight)
-MakeJoinOperator(X(Range::Types::Map<TLeft, TLeftTo>), X(Range::Types::Map<TRight, TRightTo>), class TLeft, class TLeftTo, class TRight, class TRightTo)
+    template <class TValue>
+    constexpr bool IsRange<Types::Stepped<TValue>> = true;
 
-MakeMapOperator(X(Range::Types::Range<TValue, delta>), class TValue, TValue delta)
-MakeMapOperator(X(Range::Types::Join<TRanges...>), class... TRanges)
-MakeMapOperator(X(Range::Types::Map<TRange, TTo>), class TRange, class TTo)
+    template <class TRange>
+    constexpr bool IsRange<Types::Reversed<TRange>> = true;
 
-MakeJoinOperator(X(Range::Types::Join<TLeft...>), X(Range::Types::Range<TRight, rDelta>), class... TLeft, class TRight, TRight rDelta)
-MakeJoinOperator(X(Range::Types::Range<TLeft, lDelta>), X(Range::Types::Join<TRight...>), class TLeft, TLeft lDelta, class... TRight)
+    template <class... TRanges>
+    constexpr bool IsRange<Types::Join<TRanges...>> = true;
 
-MakeJoinOperator(X(Range::Types::Map<TLeft, TLeftTo>), X(Range::Types::Range<TRight, rDelta>), class TLeft, class TLeftTo, class TRight, TRight rDelta)
-MakeJoinOperator(X(Range::Types::Range<TLeft, lDelta>), X(Range::Types::Map<TRight, TRightTo>), class TLeft, TLeft lDelta, class TRight, class TRightTo)
+    template <class TRange, class TTo, class TFunctor>
+    constexpr bool IsRange<Types::Map<TRange, TTo, TFunctor>> = true;
+}
 
-MakeJoinOperator(X(Range::Types::Map<TLeft, TLeftTo>), X(Range::Types::Join<TRight...>), class TLeft, class TLeftTo, class... TRight)
-MakeJoinOperator(X(Range::Types::Join<TLeft...>), X(Range::Types::Map<TRight, TRightTo>), class... TLeft, class TRight, class TRightTo)
+template <class TLeft, class TRight, class = Types::EnableIf<Range::IsRange<TLeft> && Range::IsRange<TRight>, void>>
+FORCEINLINE constexpr auto operator*(TLeft left, TRight right) { return Range::Types::Join<TLeft, TRight>{ left, right, }; }
 
-#undef MakeJoinOperator
-#undef MakeMapOperator
-#undef X
+template <class TRange, class TFunctor, class = Types::EnableIf<Range::IsRange<TRange>, void>>
+FORCEINLINE constexpr auto operator|(TRange left, TFunctor right) { return Range::Types::Map<TRange, decltype(right(*left.begin())), TFunctor>{ left, right, }; }
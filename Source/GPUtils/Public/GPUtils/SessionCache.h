@@ -0,0 +1,128 @@
+#pragma once
+
+#include <GPUtils/Sessions.h>
+
+#include <CoreMinimal.h>
+#include <Subsystems/GameInstanceSubsystem.h>
+
+#include "SessionCache.generated.h"
+
+// What a session search looks for. Searches with the same query find the same sessions, so they share one cache entry.
+USTRUCT(BlueprintType)
+struct FSessionQuery
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool lan = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool presence = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 maxResults = 50;
+
+	// Online subsystem to search with, the default one when none.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName subsystem;
+
+	// Extra search filters passed to the subsystem as query settings the sessions must equal, e.g. a game mode or a region.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TMap<FName, FString> settings;
+
+	// Only bounds how long a refresh takes, queries differing in it share their entry.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 timeoutInSeconds = 10;
+};
+
+UENUM(BlueprintType)
+enum class ESessionChange : uint8
+{
+	Added,
+	Updated,
+	Removed,
+};
+
+// `session.sessionId` identifies the row. Its `id` belongs to the search the cache got it from, join through USessionCache::JoinSessionAsync instead.
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FSessionChangeHandler, ESessionChange, change, const FSessionResult&, session);
+
+// Sessions last found by one query, with the subscribers to its changes.
+UCLASS()
+class GPUTILS_API USessionCacheEntry : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	FSessionQuery query;
+
+	// Cached rows, with the search each came from, which is the one to join through.
+	UPROPERTY()
+	TArray<FSessionResult> sessions;
+
+	UPROPERTY()
+	TArray<UFindSessionsTask*> sources;
+
+	UPROPERTY()
+	UFindSessionsTask* refreshing = nullptr;
+
+	TArray<FSessionChangeHandler> handlers;
+
+	// FPlatformTime::Seconds of the last successful refresh, 0 before the first one.
+	double refreshedAt = 0;
+
+	// Searches again unless a refresh is already running. Sessions the search finds are merged in as they arrive, the ones it doesn't find are
+	// removed once it completes. A failed search keeps the cached sessions.
+	void Refresh(ULocalPlayer* player);
+
+	bool IsStale() const;
+
+private:
+	// Sessions the running refresh found so far.
+	TSet<FString> found;
+
+	UFUNCTION()
+	void OnBatch(const TArray<FSessionResult>& batch);
+
+	UFUNCTION()
+	void OnComplete(EFindSessionsResult status);
+
+	void Broadcast(ESessionChange change, const FSessionResult& session) const;
+};
+
+// Keeps the sessions found per query across server browser visits, so that opening the browser shows the last results right away while they are
+// searched again in the background, and several browsers open at once share one search. Subscribers only hear about the rows that changed.
+// Entries are refreshed when subscribed to after GPUtils.SessionCache.TTLSeconds, or on request.
+UCLASS()
+class GPUTILS_API USessionCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Reports the cached sessions of the query as Added right away, then the changes every later refresh finds. Refreshes when the cached
+	// sessions are stale.
+	UFUNCTION(BlueprintCallable)
+	void Subscribe(ULocalPlayer* player, const FSessionQuery& query, FSessionChangeHandler handler);
+
+	UFUNCTION(BlueprintCallable)
+	void Unsubscribe(const FSessionQuery& query, FSessionChangeHandler handler);
+
+	// Searches again even if the cached sessions are still fresh, unless a refresh of the query is already running.
+	UFUNCTION(BlueprintCallable)
+	void Refresh(ULocalPlayer* player, const FSessionQuery& query);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	TArray<FSessionResult> GetCachedSessions(const FSessionQuery& query) const;
+
+	// Marks the cached sessions of all queries stale, so that the next subscription to each refreshes it. They are still reported meanwhile.
+	UFUNCTION(BlueprintCallable)
+	void Invalidate();
+
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "worldContext", HidePin = "worldContext"))
+	void JoinSessionAsync(UObject* worldContext, ULocalPlayer* player, const FSessionQuery& query, const FString& sessionId, FJoinSessionResultHandler callback);
+
+private:
+	UPROPERTY()
+	TMap<FString, USessionCacheEntry*> entries;
+
+	USessionCacheEntry* FindOrAddEntry(const FSessionQuery& query);
+};
@@ -71,6 +71,68 @@ DECLARE_DYNAMIC_DELEGATE_OneParam(FDestroySessionResultHandler, EDestroySessionR
 
 class ULocalPlayer;
 
+// Search result with everything a server list shows, extracted once when the search delivers it.
+USTRUCT(BlueprintType)
+struct FSessionResult
+{
+	GENERATED_BODY()
+
+	// Index to join with UFindSessionsTask::JoinSessionAsync.
+	UPROPERTY(BlueprintReadOnly)
+	int32 id = 0;
+
+	// Identifies the session across searches.
+	UPROPERTY(BlueprintReadOnly)
+	FString sessionId;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString mapName;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString ownerName;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ping = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 publicSlots = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 openPublicSlots = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 privateSlots = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 openPrivateSlots = 0;
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSessionBatchHandler, const TArray<FSessionResult>&, batch);
+
+// Time spent per phase of the joins since the last reset. The local controller is looked up before the join request goes out, so the time that took
+// counts as saved instead of delaying the travel once the join completed. The joined session's connect string is authoritative, the one of its
+// search result only stands in when it doesn't resolve.
+struct FJoinLatencyStats
+{
+	int32 joins = 0;
+
+	// From the join request to its completion.
+	double joinMs = 0;
+
+	double resolveMs = 0;
+
+	// Joins that traveled to the search result's connect string because the joined session didn't resolve, and joins where the two were different.
+	int32 resolveFallbacks = 0;
+	int32 searchResultMismatches = 0;
+
+	double controllerMs = 0;
+	double controllerSavedMs = 0;
+	double travelMs = 0;
+};
+
+GPUTILS_API FJoinLatencyStats GetJoinLatencyStats(bool reset = false);
+
+// Wrapper of one FSessionResult, kept for existing Blueprints. UFindSessionsTask::GetSessionResults avoids the objects altogether.
 UCLASS(BlueprintType)
 class GPUTILS_API USessionDetails : public UObject
 {
@@ -80,8 +142,9 @@ public:
 	UPROPERTY()
 	class UFindSessionsTask* sessions;
 
+	// Copied when the object is created, so the getters stay valid after the task searched again. Joining looks the session up by its id.
 	UPROPERTY()
-	int32 id;
+	FSessionResult result;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	FString GetMapName() const;
@@ -106,50 +169,84 @@ public:
 	static void HostSessionAsync(ULocalPlayer* player, FString name, bool lan, bool usesPresence, int32 playersLimit, FSessionStartResultHandler callback);
 
 	static void HostSessionAsync(TSharedPtr<const FUniqueNetId> userId, FName name, const FOnlineSessionSettings& settings, FSessionStartResultHandler callback);
-
-private:
-	FSessionStartResultHandler callback;
-	FDelegateHandle next;
-
-	UFUNCTION()
-	virtual void OnCreateSessionComplete(FName name, bool successful);
-
-	UFUNCTION()
-	virtual void OnStartOnlineGameComplete(FName name, bool successful);
 };
 
+// Drops the queued searches and unbinds from the sessions interfaces they were queued on, so that the interfaces aren't kept alive past their online
+// subsystem. Called by the module on shutdown.
+GPUTILS_API void ShutdownSessionSearches();
+
+// Searches share their sessions interface, which runs one of them at a time: they are started in request order and each completion goes to its own
+// task. Searches through different online subsystems, e.g. LAN through the null subsystem and online through the platform one, run in parallel.
 UCLASS(BlueprintType)
 class GPUTILS_API UFindSessionsTask : public UObject
 {
 	GENERATED_BODY()
 
+	friend class FSessionSearchQueue;
+
 public:
 	FFindSessionResultHandler callback;
 	TSharedPtr<FOnlineSessionSearch> search;
 
+	// Online subsystem to search with, the default one when none.
+	FName subsystem;
+
 	UFindSessionsTask();
 
 	UFUNCTION(BlueprintCallable)
 	static UFindSessionsTask* FindSessionsAsync(ULocalPlayer* player, bool lan, bool presence, int32 timeoutInSeconds, FFindSessionResultHandler callback);
 
+	// Up to maxResults sessions, delivered to onBatch in batches of at most pageSize as the online subsystem reports them, from the frame they arrive.
+	// Delivered sessions can be joined right away. `callback` fires when the search completes.
+	UFUNCTION(BlueprintCallable)
+	static UFindSessionsTask* FindSessionsStreamingAsync(ULocalPlayer* player, bool lan, bool presence, int32 timeoutInSeconds, int32 maxResults, int32 pageSize, FSessionBatchHandler onBatch, FFindSessionResultHandler callback, FName subsystem = NAME_None);
+
+	// Task configured like FindSessionsStreamingAsync's but not started yet, to be started with FindSessionsAsync(userId).
+	static UFindSessionsTask* CreateSearch(bool lan, bool presence, int32 timeoutInSeconds, int32 maxResults, int32 pageSize, FSessionBatchHandler onBatch, FFindSessionResultHandler callback, FName subsystem = NAME_None);
+
+	// Searches again, giving up the task's own search if it's still queued or running. Other tasks' searches are left alone.
 	bool FindSessionsAsync(TSharedPtr<const FUniqueNetId> userId);
 
+	// Returns the join task, nullptr when the join failed right away. Keep it referenced until the callback fired, nothing else does.
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "worldContext", HidePin = "worldContext"))
-	void JoinSessionAsync(UObject* worldContext, ULocalPlayer* player, int32 sessionId, FJoinSessionResultHandler callback);
+	class UJoinSessionTask* JoinSessionAsync(UObject* worldContext, ULocalPlayer* player, int32 sessionId, FJoinSessionResultHandler callback);
 
+	// Results of the current search: the ones delivered so far while streaming, all of them once it completed. Extracted once per result.
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	const TArray<FSessionResult>& GetSessionResults() const { return results; }
+
+	// Same results as objects, created once per result.
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	TArray<USessionDetails*> GetSessions();
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	FString GetSearchState() const { return EOnlineAsyncTaskState::ToString(search->SearchState); }
 
+	// Sessions found by any of the tasks, each one once: a session several searches found is kept from the one that measured the lowest ping.
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	static TArray<USessionDetails*> MergeSessions(const TArray<UFindSessionsTask*>& tasks);
+
 private:
-	FDelegateHandle next;
+	FDelegateHandle poll;
+	FSessionBatchHandler onBatch;
+	int32 pageSize = 0;
+
+	UPROPERTY()
+	TArray<FSessionResult> results;
+
+	UPROPERTY()
+	TArray<USessionDetails*> details;
 
 	UFUNCTION()
 	virtual void OnFindSessionsComplete(bool successful);
+
+	// Extracts the results the subsystem added to the search since the last call and hands them to onBatch.
+	void DeliverNewResults();
+
+	void StopPolling();
 };
 
+class APlayerController;
 class UWorld;
 
 UCLASS()
@@ -161,11 +258,22 @@ public:
 	UWorld* world;
 	FJoinSessionResultHandler callback;
 
+	// Online subsystem the session was found with, the default one when none.
+	FName subsystem;
+
+	// Travel URL resolved from the search result, used when the joined session doesn't resolve. Empty when there is none.
+	FString connectString;
+
 	void JoinSessionAsync(TSharedPtr<const FUniqueNetId> userId, FName sessionName, const FOnlineSessionSearchResult& searchResult);
 
 private:
 	FDelegateHandle next;
 
+	// Looked up while the join request is in flight.
+	TWeakObjectPtr<APlayerController> controller;
+	uint64 controllerCycles = 0;
+	uint64 requested = 0;
+
 	virtual void OnJoinSessionComplete(FName sessionName, EOnJoinSessionCompleteResult::Type result);
 };
 
@@ -177,7 +285,10 @@ class GPUTILS_API UDestroySessionTask : public UObject
 public:
 	FDestroySessionResultHandler callback;
 
-	static void DestroySessionAsync(FName name, FDestroySessionResultHandler callback);
+	// Online subsystem the session belongs to, the default one when none.
+	FName subsystem;
+
+	static void DestroySessionAsync(FName name, FDestroySessionResultHandler callback, FName subsystem = NAME_None);
 
 	void DestroySessionAsync(FName name);
 
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Math/VectorRegister.h>
+
+namespace Simd
+{
+    namespace Detail
+    {
+        template <class TValue>
+        struct Register
+        {
+            static constexpr bool supported = false;
+        };
+
+        template <>
+        struct Register<float>
+        {
+            static constexpr bool supported = true;
+            using Type = VectorRegister;
+
+            static FORCEINLINE Type Load(const float* values) { return VectorLoadAligned(values); }
+            static FORCEINLINE void Store(const Type& value, float* values) { VectorStoreAligned(value, values); }
+            static FORCEINLINE Type Add(const Type& l, const Type& r) { return VectorAdd(l, r); }
+            static FORCEINLINE Type Subtract(const Type& l, const Type& r) { return VectorSubtract(l, r); }
+            static FORCEINLINE Type Multiply(const Type& l, const Type& r) { return VectorMultiply(l, r); }
+            static FORCEINLINE Type Divide(const Type& l, const Type& r) { return VectorDivide(l, r); }
+            static FORCEINLINE Type Min(const Type& l, const Type& r) { return VectorMin(l, r); }
+            static FORCEINLINE Type Max(const Type& l, const Type& r) { return VectorMax(l, r); }
+        };
+
+        template <>
+        struct Register<int32>
+        {
+            static constexpr bool supported = true;
+            using Type = VectorRegisterInt;
+
+            static FORCEINLINE Type Load(const int32* values) { return VectorIntLoadAligned(values); }
+            static FORCEINLINE void Store(const Type& value, int32* values) { VectorIntStoreAligned(value, values); }
+            static FORCEINLINE Type Add(const Type& l, const Type& r) { return VectorIntAdd(l, r); }
+            static FORCEINLINE Type Subtract(const Type& l, const Type& r) { return VectorIntSubtract(l, r); }
+            static FORCEINLINE Type Multiply(const Type& l, const Type& r) { return VectorIntMultiply(l, r); }
+            static FORCEINLINE Type Min(const Type& l, const Type& r) { return VectorIntMin(l, r); }
+            static FORCEINLINE Type Max(const Type& l, const Type& r) { return VectorIntMax(l, r); }
+
+            static FORCEINLINE Type Divide(const Type& l, const Type& r)
+            {
+                alignas(16) int32 left[4];
+                alignas(16) int32 right[4];
+                Store(l, left);
+                Store(r, right);
+                for (auto i = 0; i < 4; ++i)
+                    left[i] = right[i] != 0 ? left[i] / right[i] : 0;
+                return Load(left);
+            }
+        };
+
+        // Register<TValue> named through the lambda argument `TArg`, so that the vector operations of types without a register are only looked up
+        // when they're called.
+        template <class TValue, class TArg>
+        struct DependentRegister
+        {
+            using Type = Register<TValue>;
+        };
+    }
+
+    // A register-width pack of values. count tells how many leading lanes are meaningful, the rest repeat the last valid one.
+    // Always four lanes: VectorRegister is 128 bits wide on every platform, there's no 8-wide (AVX) path.
+    template <class TValue>
+    struct alignas(16) Lanes
+    {
+        using Value = TValue;
+        static constexpr int32 width = 4;
+
+        TValue values[width];
+        int32 count = width;
+
+        static FORCEINLINE Lanes Splat(TValue value)
+        {
+            auto ret = Lanes{};
+            for (auto& v : ret.values)
+                v = value;
+            return ret;
+        }
+
+        FORCEINLINE bool IsFull() const { return count == width; }
+
+        FORCEINLINE void Pad()
+        {
+            for (auto i = count; i < width; ++i)
+                values[i] = values[count - 1];
+        }
+
+        template <class TScalar, class TVector>
+        FORCEINLINE Lanes Zip(const Lanes& other, TScalar scalar, TVector vector) const
+        {
+            auto ret = Lanes{};
+            ret.count = FMath::Min(count, other.count);
+            if constexpr (Detail::Register<TValue>::supported)
+            {
+                using Register = Detail::Register<TValue>;
+                Register::Store(vector(Register::Load(values), Register::Load(other.values)), ret.values);
+            }
+            else
+            {
+                for (auto i = 0; i < width; ++i)
+                    ret.values[i] = scalar(values[i], other.values[i]);
+            }
+            return ret;
+        }
+    };
+
+    template <class TValue>
+    constexpr bool IsLanes = false;
+
+    template <class TValue>
+    constexpr bool IsLanes<Lanes<TValue>> = true;
+
+#define MakeLanesOperator(op, Name) \
+    template <class TValue> \
+    FORCEINLINE Lanes<TValue> operator op(const Lanes<TValue>& l, const Lanes<TValue>& r) \
+    { \
+        return l.Zip(r, [](const TValue& a, const TValue& b) { return a op b; }, [](const auto& a, const auto& b) { return Detail::DependentRegister<TValue, decltype(a)>::Type::Name(a, b); }); \
+    } \
+    template <class TValue> \
+    FORCEINLINE Lanes<TValue> operator op(const Lanes<TValue>& l, typename Lanes<TValue>::Value r) { return l op Lanes<TValue>::Splat(r); } \
+    template <class TValue> \
+    FORCEINLINE Lanes<TValue> operator op(typename Lanes<TValue>::Value l, const Lanes<TValue>& r) { auto ret = Lanes<TValue>::Splat(l) op r; ret.count = r.count; return ret; }
+
+    MakeLanesOperator(+, Add)
+    MakeLanesOperator(-, Subtract)
+    MakeLanesOperator(*, Multiply)
+    MakeLanesOperator(/, Divide)
+
+#undef MakeLanesOperator
+
+    template <class TValue>
+    FORCEINLINE TValue Min(const TValue& l, const TValue& r) { return FMath::Min(l, r); }
+
+    template <class TValue>
+    FORCEINLINE TValue Max(const TValue& l, const TValue& r) { return FMath::Max(l, r); }
+
+    template <class TValue>
+    FORCEINLINE Lanes<TValue> Min(const Lanes<TValue>& l, const Lanes<TValue>& r)
+    {
+        return l.Zip(r, [](const TValue& a, const TValue& b) { return FMath::Min(a, b); }, [](const auto& a, const auto& b) { return Detail::DependentRegister<TValue, decltype(a)>::Type::Min(a, b); });
+    }
+
+    template <class TValue>
+    FORCEINLINE Lanes<TValue> Max(const Lanes<TValue>& l, const Lanes<TValue>& r)
+    {
+        return l.Zip(r, [](const TValue& a, const TValue& b) { return FMath::Max(a, b); }, [](const auto& a, const auto& b) { return Detail::DependentRegister<TValue, decltype(a)>::Type::Max(a, b); });
+    }
+
+    template <class TFunctor>
+    struct PackedFunctor
+    {
+        TFunctor functor;
+    };
+
+    // Marks a functor that takes whole packs: Range::Batch(range) | Simd::Packed([](auto v) { return v * 2 + 1; }). Opt-in, since whether a generic
+    // lambda accepts a pack can't be tested without instantiating its body, which is a hard error for scalar-only ones like [](auto v) { return FMath::Sqrt(v); }.
+    template <class TFunctor>
+    FORCEINLINE PackedFunctor<std::decay_t<TFunctor>> Packed(TFunctor&& functor) { return { Forward<TFunctor>(functor), }; }
+
+    template <class TFunctor>
+    constexpr bool IsPacked = false;
+
+    template <class TFunctor>
+    constexpr bool IsPacked<PackedFunctor<TFunctor>> = true;
+
+    // Calls a Packed functor once with the whole pack, any other functor once per lane.
+    template <class TFunctor, class TValue>
+    FORCEINLINE auto Apply(const PackedFunctor<TFunctor>& packed, const Lanes<TValue>& lanes)
+    {
+        auto ret = packed.functor(lanes);
+        ret.count = lanes.count;
+        return ret;
+    }
+
+    template <class TFunctor, class TValue>
+    FORCEINLINE auto Apply(const TFunctor& functor, const Lanes<TValue>& lanes)
+    {
+        auto ret = Lanes<decltype(functor(lanes.values[0]))>{};
+        ret.count = lanes.count;
+        for (auto i = 0; i < lanes.count; ++i)
+            ret.values[i] = functor(lanes.values[i]);
+        ret.Pad();
+        return ret;
+    }
+}
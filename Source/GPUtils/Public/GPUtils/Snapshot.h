@@ -0,0 +1,91 @@
+#pragma once
+
+#include <GPUtils/Types.h>
+#include <GPUtils/View.h>
+
+#include <Async/ParallelFor.h>
+#include <CoreMinimal.h>
+
+// Structure of arrays copy of a few fields of every actor in a range, for processing actor data on worker threads without chasing actor pointers:
+//
+// auto snapshot = MakeSnapshot<AFoo>([](const AFoo* foo) { return foo->GetActorLocation(); }, [](const AFoo* foo) { return foo->speed; });
+// snapshot.Gather(ActorRange<AFoo>(world));                       // game thread
+// snapshot.ParallelChunks([&](int32 from, int32 to) { ... });     // reads snapshot.Get<0>() / View<1>(from, to), writes own buffers
+// snapshot.Scatter(results, [](AFoo* foo, float speed) { foo->speed = speed; }); // game thread
+//
+// Buffers keep their allocation between Gather calls, so a snapshot kept as a member doesn't allocate once it has seen the largest actor count.
+template <class TActor, class... TGetters>
+class ActorSnapshot
+{
+public:
+	using Fields = TTuple<TArray<typename TDecay<decltype(DeclVal<const TGetters&>()(DeclVal<const TActor*>()))>::Type>...>;
+
+	ActorSnapshot(TGetters... getters_) : getters(MoveTemp(getters_)...) {}
+
+	// Refills the buffers from a range of actor pointers (ActorRange, SpatialRange, a TArray, ...). Must run on the game thread.
+	template <class TRange>
+	void Gather(const TRange& range)
+	{
+		check(IsInGameThread());
+
+		actors.Reset();
+		fields.ApplyBefore([](auto&... arrays) { (arrays.Reset(), ...); });
+
+		for (TActor* actor : range)
+		{
+			actors.Add(actor);
+			Append(actor, Types::MakeIndexSequence<sizeof...(TGetters)>{});
+		}
+	}
+
+	FORCEINLINE_DEBUGGABLE int32 Num() const { return actors.Num(); }
+	// Weak, a snapshot may outlive a garbage collection while the workers process it.
+	FORCEINLINE_DEBUGGABLE const TArray<TWeakObjectPtr<TActor>>& GetActors() const { return actors; }
+
+	template <std::size_t index>
+	FORCEINLINE_DEBUGGABLE const auto& Get() const { return fields.template Get<index>(); }
+
+	// Contiguous view of field `index` for elements [from, to), e.g. for Range::Transform.
+	template <std::size_t index>
+	FORCEINLINE_DEBUGGABLE auto View(int32 from, int32 to) const { return Range::View(Get<index>().GetData() + from, to - from); }
+
+	// Runs functor(from, to) for consecutive chunks of the snapshot on the task graph and waits for all of them.
+	template <class TFunctor>
+	void ParallelChunks(const TFunctor& functor, int32 chunkSize = 1024) const
+	{
+		chunkSize = FMath::Max(chunkSize, 1);
+		const auto num = Num();
+		ParallelFor((num + chunkSize - 1) / chunkSize, [&](int32 chunk)
+			{
+				const auto from = chunk * chunkSize;
+				functor(from, FMath::Min(from + chunkSize, num));
+			});
+	}
+
+	// Calls setter(actor, values[i]) for the i-th gathered actor. Must run on the game thread, actors destroyed or collected since Gather are skipped.
+	// That can be frames later: the actors are held weakly.
+	template <class TValue, class TAllocator, class TSetter>
+	void Scatter(const TArray<TValue, TAllocator>& values, const TSetter& setter) const
+	{
+		check(IsInGameThread());
+		check(values.Num() == actors.Num());
+
+		for (auto i = 0; i < actors.Num(); ++i)
+			if (const auto actor = actors[i].Get())
+				setter(actor, values[i]);
+	}
+
+private:
+	TTuple<TGetters...> getters;
+	TArray<TWeakObjectPtr<TActor>> actors;
+	Fields fields;
+
+	template <std::size_t... indices>
+	FORCEINLINE_DEBUGGABLE void Append(const TActor* actor, Types::IndexSequence<indices...>)
+	{
+		(fields.template Get<indices>().Add(getters.template Get<indices>()(actor)), ...);
+	}
+};
+
+template <class TActor, class... TGetters>
+ActorSnapshot<TActor, TGetters...> MakeSnapshot(TGetters... getters) { return { MoveTemp(getters)... }; }
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <ConvexVolume.h>
+
+namespace Spatial
+{
+    // Query shapes. GetBounds returns an invalid box when the shape has no cheap bounding box, the grid then tests every occupied cell with IntersectsCell.
+    struct Sphere
+    {
+        FVector center;
+        float radius;
+
+        FORCEINLINE_DEBUGGABLE FBox GetBounds() const { return { center - FVector{ radius }, center + FVector{ radius }, }; }
+        FORCEINLINE_DEBUGGABLE bool IntersectsCell(const FBox& cell) const { return FMath::SphereAABBIntersection(center, radius * radius, cell); }
+        FORCEINLINE_DEBUGGABLE bool Contains(const FVector& location) const { return FVector::DistSquared(location, center) <= radius * radius; }
+    };
+
+    struct Box
+    {
+        FBox box;
+
+        FORCEINLINE_DEBUGGABLE FBox GetBounds() const { return box; }
+        FORCEINLINE_DEBUGGABLE bool IntersectsCell(const FBox& cell) const { return box.Intersect(cell); }
+        FORCEINLINE_DEBUGGABLE bool Contains(const FVector& location) const { return box.IsInsideOrOn(location); }
+    };
+
+    struct Frustum
+    {
+        FConvexVolume volume;
+
+        FORCEINLINE_DEBUGGABLE FBox GetBounds() const { return FBox{ ForceInit }; }
+        FORCEINLINE_DEBUGGABLE bool IntersectsCell(const FBox& cell) const { return volume.IntersectBox(cell.GetCenter(), cell.GetExtent()); }
+        FORCEINLINE_DEBUGGABLE bool Contains(const FVector& location) const { return volume.IntersectPoint(location); }
+    };
+
+    // Uniform grid of points. Only occupied cells are stored, so the world doesn't need known bounds and moving an element touches at most two cells.
+    template <class TElement>
+    class Grid
+    {
+    public:
+        explicit Grid(float cellSize_ = 1000.f) : cellSize(FMath::Max(cellSize_, KINDA_SMALL_NUMBER)) {}
+
+        void Add(const TElement& element, const FVector& location)
+        {
+            if (slots.Contains(element))
+            {
+                Move(element, location);
+                return;
+            }
+
+            const auto cell = ToCell(location);
+            auto& entries = cells.FindOrAdd(cell);
+            slots.Add(element, { cell, entries.Add({ element, location, }), });
+        }
+
+        void Remove(const TElement& element)
+        {
+            Slot slot;
+            if (!slots.RemoveAndCopyValue(element, slot))
+                return;
+
+            auto& entries = cells[slot.cell];
+            entries.RemoveAtSwap(slot.index, 1, false);
+            if (slot.index < entries.Num())
+                slots[entries[slot.index].element].index = slot.index;
+            if (entries.Num() == 0)
+                cells.Remove(slot.cell);
+        }
+
+        void Move(const TElement& element, const FVector& location)
+        {
+            const auto slot = slots.Find(element);
+            if (slot == nullptr)
+                return;
+
+            if (ToCell(location) == slot->cell)
+            {
+                cells[slot->cell][slot->index].location = location;
+                return;
+            }
+
+            Remove(element);
+            Add(element, location);
+        }
+
+        // Calls visitor(element) for every element whose recorded location is inside of the shape. Const and lock free, so several queries can run in parallel.
+        template <class TShape, class TVisitor>
+        void ForEach(const TShape& shape, const TVisitor& visitor) const
+        {
+            const auto visitCell = [&](const TArray<Entry>& entries)
+            {
+                for (const auto& entry : entries)
+                    if (shape.Contains(entry.location))
+                        visitor(entry.element);
+            };
+
+            const auto bounds = shape.GetBounds();
+            if (bounds.IsValid)
+            {
+                const auto from = ToCell(bounds.Min);
+                const auto to = ToCell(bounds.Max);
+                const auto span = static_cast<int64>(to.X - from.X + 1) * (to.Y - from.Y + 1) * (to.Z - from.Z + 1);
+                if (span <= cells.Num())
+                {
+                    for (auto x = from.X; x <= to.X; ++x)
+                        for (auto y = from.Y; y <= to.Y; ++y)
+                            for (auto z = from.Z; z <= to.Z; ++z)
+                                if (const auto entries = cells.Find({ x, y, z, }))
+                                    visitCell(*entries);
+                    return;
+                }
+            }
+
+            for (const auto& pair : cells)
+                if (shape.IntersectsCell(GetCellBox(pair.Key)))
+                    visitCell(pair.Value);
+        }
+
+        FORCEINLINE_DEBUGGABLE int32 Num() const { return slots.Num(); }
+        FORCEINLINE_DEBUGGABLE float GetCellSize() const { return cellSize; }
+
+    private:
+        struct Entry
+        {
+            TElement element;
+            FVector location;
+        };
+
+        struct Slot
+        {
+            FIntVector cell;
+            int32 index;
+        };
+
+        float cellSize;
+        TMap<FIntVector, TArray<Entry>> cells;
+        TMap<TElement, Slot> slots;
+
+        FORCEINLINE_DEBUGGABLE FIntVector ToCell(const FVector& location) const
+        {
+            return { FMath::FloorToInt(location.X / cellSize), FMath::FloorToInt(location.Y / cellSize), FMath::FloorToInt(location.Z / cellSize), };
+        }
+
+        FORCEINLINE_DEBUGGABLE FBox GetCellBox(const FIntVector& cell) const
+        {
+            const auto min = FVector{ cell } * cellSize;
+            return { min, min + FVector{ cellSize }, };
+        }
+    };
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <GPUtils/ActorRange.h>
+#include <GPUtils/SpatialGrid.h>
+
+#include <Async/ParallelFor.h>
+#include <CoreMinimal.h>
+#include <Engine/EngineTypes.h>
+#include <Engine/World.h>
+#include <Subsystems/WorldSubsystem.h>
+
+#include "SpatialIndex.generated.h"
+
+class AActor;
+class ULevel;
+class USceneComponent;
+
+// Per-class uniform grids of actor locations, updated from spawn, movement and end play events. Opt-in per class:
+// world->GetSubsystem<USpatialIndexSubsystem>()->EnableIndex<AFoo>(500.f); after which SphereRange<AFoo> and friends only visit nearby cells.
+UCLASS()
+class GPUTILS_API USpatialIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	using Grid = Spatial::Grid<AActor*>;
+
+	virtual void Initialize(FSubsystemCollectionBase& collection) override;
+	virtual void Deinitialize() override;
+
+	// Starts indexing actors of the class and its subclasses. cellSize should be around the typical query radius.
+	void EnableIndex(UClass* actorClass, float cellSize = 1000.f);
+
+	template <class TActor>
+	void EnableIndex(float cellSize = 1000.f) { EnableIndex(TActor::StaticClass(), cellSize); }
+
+	// Grid of an indexed class, nullptr when the class isn't indexed.
+	const Grid* Find(UClass* actorClass) const;
+
+private:
+	// Classes are kept alive by the engine for the lifetime of the world, so the keys don't need to be reported to the GC.
+	TMap<UClass*, TUniquePtr<Grid>> grids;
+
+	FDelegateHandle actorSpawned;
+	FDelegateHandle levelAdded;
+
+	void Add(AActor* actor, Grid& grid);
+	void OnActorSpawned(AActor* actor);
+	void OnTransformUpdated(USceneComponent* component, EUpdateTransformFlags flags, ETeleportType teleport);
+
+	UFUNCTION()
+	void OnActorEndPlay(AActor* actor, EEndPlayReason::Type reason);
+
+	void OnLevelAdded(ULevel* level, UWorld* world);
+};
+
+// Actors of the given class whose location is inside of a Spatial shape. Matches are gathered up front, so the loop body may freely move, spawn or destroy actors.
+// Classes without a spatial index fall back to testing every actor of ActorRange.
+template <class TActor>
+class SpatialRange
+{
+public:
+	using Element = TActor*;
+
+	SpatialRange() = default;
+
+	template <class TShape>
+	SpatialRange(UWorld* world, const TShape& shape)
+	{
+		const auto index = world ? world->GetSubsystem<USpatialIndexSubsystem>() : nullptr;
+		if (const auto grid = index ? index->Find(TActor::StaticClass()) : nullptr)
+		{
+			grid->ForEach(shape, [&](AActor* actor)
+				{
+					if (IsValid(actor))
+						actors.Add(static_cast<TActor*>(actor));
+				});
+		}
+		else
+		{
+			for (const auto actor : ActorRange<TActor>(world))
+				if (shape.Contains(actor->GetActorLocation()))
+					actors.Add(actor);
+		}
+	}
+
+	FORCEINLINE_DEBUGGABLE auto begin() const { return actors.begin(); }
+	FORCEINLINE_DEBUGGABLE auto end() const { return actors.end(); }
+	FORCEINLINE_DEBUGGABLE int32 Num() const { return actors.Num(); }
+
+private:
+	TArray<TActor*> actors;
+};
+
+template <class TActor>
+SpatialRange<TActor> SphereRange(UWorld* world, const FVector& center, float radius) { return { world, Spatial::Sphere{ center, radius, }, }; }
+
+template <class TActor>
+SpatialRange<TActor> BoxRange(UWorld* world, const FBox& box) { return { world, Spatial::Box{ box, }, }; }
+
+template <class TActor>
+SpatialRange<TActor> FrustumRange(UWorld* world, const FConvexVolume& volume) { return { world, Spatial::Frustum{ volume, }, }; }
+
+// Runs one query per shape, in parallel when the class is indexed. Must be called from the game thread, which is blocked until all queries are done.
+template <class TActor, class TShape>
+TArray<SpatialRange<TActor>> QueryBatch(UWorld* world, TArrayView<const TShape> shapes)
+{
+	auto ret = TArray<SpatialRange<TActor>>{};
+	ret.SetNum(shapes.Num());
+
+	const auto index = world ? world->GetSubsystem<USpatialIndexSubsystem>() : nullptr;
+	const auto indexed = index && index->Find(TActor::StaticClass());
+	ParallelFor(shapes.Num(), [&](int32 i) { ret[i] = SpatialRange<TActor>{ world, shapes[i], }; }, !indexed);
+
+	return ret;
+}
@@ -1,5 +1,67 @@
 #pragma once
 
+#include <GPUtils/Jobs.h>
+
 #include <CoreMinimal.h>
 
+// Runs the delegate on the game thread: immediately when called from it, otherwise at the next drain of the game thread queue.
+// Workers push into a lock-free MPSC queue instead of posting a task graph task per call. A single task graph task is posted when the queue stops
+// being empty, which drains it too: the game thread may be blocked waiting on the task graph (a task, a blocking load) for one of these delegates,
+// then the drain points never come.
 void GPUTILS_API ExecuteInGameThread(TUniqueFunction<void()>&& delegate);
+
+// Points of the frame where the game thread queue can be drained, selected with GPUtils.GameThreadQueue.DrainPoint.
+enum class EGameThreadDrainPoint : uint8
+{
+	EngineTick,      // Core ticker, once per engine loop iteration. Works without a world.
+	WorldTickStart,  // Before the actors of a world tick.
+	PostActorTick,   // After the actors of a world ticked, before rendering.
+};
+
+// Runs queued delegates if `point` is the configured drain point, within the GPUtils.GameThreadQueue.MaxMsPerDrain budget. Game thread only.
+// The module calls it at every drain point, call it with force to flush at a specific place.
+void GPUTILS_API DrainGameThreadQueue(EGameThreadDrainPoint point, bool force = false);
+
+// Runs queued delegates until there are none left, including the ones they queue, regardless of the budget. Game thread only, e.g. on shutdown.
+void GPUTILS_API FlushGameThreadQueue();
+
+struct FGameThreadQueueStats
+{
+	uint64 executed = 0;
+	int32 pending = 0;
+	double averageLatencyMs = 0;
+	double maxLatencyMs = 0;
+};
+
+// Enqueue-to-run latency of the delegates executed since the last reset.
+FGameThreadQueueStats GPUTILS_API GetGameThreadQueueStats(bool reset = false);
+
+// Splits long game thread work across frames. `step` is called repeatedly until it returns false, each frame as long as the
+// GPUtils.GameThreadBudget.Ms budget lasts: higher priorities first, the steps of one priority in turn. Work that doesn't fit resumes next frame.
+// At least one step runs per frame however small the budget, and with no budget (0) every pending step runs once per frame.
+// Callable from any thread, steps always run on the game thread.
+void GPUTILS_API ExecuteInGameThreadBudgeted(TUniqueFunction<bool()>&& step, EJobPriority priority = EJobPriority::Normal);
+
+// Calls body(i) for every i in [0, num) on the game thread, as many per frame as the budget allows. E.g. spawning actors from a loaded list.
+void GPUTILS_API ExecuteInGameThreadChunked(int32 num, TUniqueFunction<void(int32)>&& body, EJobPriority priority = EJobPriority::Normal);
+
+// Whether this frame's budget is used up, for steps that loop internally. Always true outside of RunGameThreadBudget.
+bool GPUTILS_API IsGameThreadBudgetExhausted();
+
+// Runs budgeted steps until the budget is used up, at least one. Game thread only, the module calls it once per engine loop iteration.
+void GPUTILS_API RunGameThreadBudget();
+
+struct FGameThreadBudgetStats
+{
+	int32 pending = 0;
+	uint64 frames = 0;
+	uint64 overBudgetFrames = 0;
+	double budgetMs = 0;
+	double lastFrameMs = 0;
+	double averageFrameMs = 0;
+	double maxFrameMs = 0;
+};
+
+// Time spent on budgeted steps per frame that had any, since the last reset. A step that runs longer than what's left makes its frame go over budget.
+// Game thread only.
+FGameThreadBudgetStats GPUTILS_API GetGameThreadBudgetStats(bool reset = false);
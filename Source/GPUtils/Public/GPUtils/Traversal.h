@@ -0,0 +1,304 @@
+#pragma once
+
+#include <GPUtils/Iterators.h>
+#include <GPUtils/Range.h>
+
+#include <CoreMinimal.h>
+
+namespace Range
+{
+    namespace Types
+    {
+        template <std::size_t dimensions>
+        struct Cursor
+        {
+            int32 coordinates[dimensions] = {};
+            uint64 code = 0;
+
+            FORCEINLINE_DEBUGGABLE bool IsInside(const int32 (&extents)[dimensions]) const
+            {
+                for (auto i = 0u; i < dimensions; ++i)
+                    if (coordinates[i] >= extents[i])
+                        return false;
+                return true;
+            }
+        };
+    }
+
+    // Traversal orders for Types::Ordered. Each one starts at the zero cursor and moves it to the next cell inside of extents.
+    namespace Order
+    {
+        // Row-major order inside of tileSize^N blocks, blocks are visited in row-major order too.
+        template <std::size_t dimensions>
+        struct Tiled
+        {
+            FORCEINLINE_DEBUGGABLE Tiled(int32 tileSize_) : tileSize(FMath::Max(tileSize_, 1)) {}
+
+            FORCEINLINE_DEBUGGABLE void Prepare(const int32 (&/*unused*/)[dimensions]) {}
+
+            FORCEINLINE_DEBUGGABLE bool Advance(const int32 (&extents)[dimensions], Types::Cursor<dimensions>& cursor) const
+            {
+                auto& coordinates = cursor.coordinates;
+                ++cursor.code;
+
+                for (auto i = dimensions; i-- > 0;)
+                {
+                    const auto origin = coordinates[i] - coordinates[i] % tileSize;
+                    if (++coordinates[i] < FMath::Min(origin + tileSize, extents[i]))
+                        return true;
+                    coordinates[i] = origin;
+                }
+
+                for (auto i = dimensions; i-- > 0;)
+                {
+                    coordinates[i] += tileSize;
+                    if (coordinates[i] < extents[i])
+                        return true;
+                    coordinates[i] = 0;
+                }
+
+                return false;
+            }
+
+        private:
+            int32 tileSize;
+        };
+
+        // Z-order. Every axis is padded to the next power of two on its own, so the amount of skipped codes stays below 2^N per cell.
+        template <std::size_t dimensions>
+        struct Morton
+        {
+            FORCEINLINE_DEBUGGABLE void Prepare(const int32 (&extents)[dimensions])
+            {
+                auto total = 0u;
+                levels = 0;
+                for (auto i = 0u; i < dimensions; ++i)
+                {
+                    bits[i] = FMath::CeilLogTwo(static_cast<uint32>(extents[i]));
+                    total += bits[i];
+                    levels = FMath::Max(levels, bits[i]);
+                }
+                checkf(total < 64, TEXT("Grid is too large for a 64-bit Morton code."));
+                codes = uint64(1) << total;
+            }
+
+            FORCEINLINE_DEBUGGABLE bool Advance(const int32 (&extents)[dimensions], Types::Cursor<dimensions>& cursor) const
+            {
+                while (++cursor.code < codes)
+                {
+                    Decode(cursor);
+                    if (cursor.IsInside(extents))
+                        return true;
+                }
+                return false;
+            }
+
+        private:
+            uint32 bits[dimensions] = {};
+            uint32 levels = 0;
+            uint64 codes = 1;
+
+            FORCEINLINE_DEBUGGABLE void Decode(Types::Cursor<dimensions>& cursor) const
+            {
+                auto shift = 0u;
+                for (auto& coordinate : cursor.coordinates)
+                    coordinate = 0;
+                for (auto level = 0u; level < levels; ++level)
+                    for (auto i = dimensions; i-- > 0;)
+                        if (level < bits[i])
+                            cursor.coordinates[i] |= static_cast<int32>((cursor.code >> shift++) & 1) << level;
+            }
+        };
+
+        // Hilbert curve over the smallest power of two cube containing the grid (Skilling's transpose form).
+        // Cells outside of extents are skipped, so prefer Morton or Tiled for strongly non-square grids.
+        template <std::size_t dimensions>
+        struct Hilbert
+        {
+            FORCEINLINE_DEBUGGABLE void Prepare(const int32 (&extents)[dimensions])
+            {
+                bits = 1;
+                for (auto extent : extents)
+                    bits = FMath::Max(bits, FMath::CeilLogTwo(static_cast<uint32>(extent)));
+                checkf(bits * dimensions < 64, TEXT("Grid is too large for a 64-bit Hilbert index."));
+                codes = uint64(1) << (bits * dimensions);
+            }
+
+            FORCEINLINE_DEBUGGABLE bool Advance(const int32 (&extents)[dimensions], Types::Cursor<dimensions>& cursor) const
+            {
+                while (++cursor.code < codes)
+                {
+                    Decode(cursor);
+                    if (cursor.IsInside(extents))
+                        return true;
+                }
+                return false;
+            }
+
+        private:
+            uint32 bits = 1;
+            uint64 codes = 1;
+
+            FORCEINLINE_DEBUGGABLE void Decode(Types::Cursor<dimensions>& cursor) const
+            {
+                uint32 x[dimensions] = {};
+                for (auto level = 0u; level < bits; ++level)
+                    for (auto i = 0u; i < dimensions; ++i)
+                        x[i] |= static_cast<uint32>((cursor.code >> (level * dimensions + dimensions - 1 - i)) & 1) << level;
+
+                const auto t = x[dimensions - 1] >> 1;
+                for (auto i = dimensions - 1; i > 0; --i)
+                    x[i] ^= x[i - 1];
+                x[0] ^= t;
+
+                for (auto q = 2u; q != (2u << (bits - 1)); q <<= 1)
+                {
+                    const auto p = q - 1;
+                    for (auto i = dimensions; i-- > 0;)
+                    {
+                        if (x[i] & q)
+                        {
+                            x[0] ^= p;
+                        }
+                        else
+                        {
+                            const auto swap = (x[0] ^ x[i]) & p;
+                            x[0] ^= swap;
+                            x[i] ^= swap;
+                        }
+                    }
+                }
+
+                for (auto i = 0u; i < dimensions; ++i)
+                    cursor.coordinates[i] = static_cast<int32>(x[i]);
+            }
+        };
+    }
+
+    namespace Types
+    {
+        // Cartesian product of ranges visited in a custom order. Values of every dimension are gathered once, so the order can jump around freely.
+        template <template <std::size_t> class TOrder, class... TRanges>
+        struct Ordered
+        {
+        private:
+            static constexpr std::size_t dimensions = sizeof...(TRanges);
+            using Position = Cursor<dimensions>;
+            using Order = TOrder<dimensions>;
+            struct IteratorCtorLocker {};
+
+            struct Storage
+            {
+                TTuple<TArray<typename TRanges::Value>...> values;
+                int32 extents[dimensions];
+                Order order;
+
+                Storage(const TTuple<TRanges...>& ranges, Order order_)
+                    : order(MoveTemp(order_))
+                {
+                    Gather(ranges, ::Types::MakeIndexSequence<dimensions>{});
+                    order.Prepare(extents);
+                }
+
+                FORCEINLINE_DEBUGGABLE bool IsEmpty() const
+                {
+                    for (auto extent : extents)
+                        if (extent <= 0)
+                            return true;
+                    return false;
+                }
+
+            private:
+                template <std::size_t... indices>
+                void Gather(const TTuple<TRanges...>& ranges, ::Types::IndexSequence<indices...>)
+                {
+                    (Gather(ranges.template Get<indices>(), values.template Get<indices>(), extents[indices]), ...);
+                }
+
+                template <class TRange, class TArrayType>
+                static void Gather(const TRange& range, TArrayType& to, int32& extent)
+                {
+                    for (auto value : range)
+                        to.Add(MoveTemp(value));
+                    extent = to.Num();
+                }
+            };
+
+        public:
+            using Value = TTuple<typename TRanges::Value...>;
+
+            struct ConstIterator : Iterators::ConstBase<Position, ConstIterator>
+            {
+            private:
+                using Base = Iterators::ConstBase<Position, ConstIterator>;
+                friend Base;
+
+            public:
+                FORCEINLINE_DEBUGGABLE ConstIterator() = default;
+
+                FORCEINLINE_DEBUGGABLE ConstIterator(IteratorCtorLocker, TSharedPtr<const Storage> storage_)
+                    : Base(storage_->IsEmpty() ? ::Types::Optional<Position>{} : Position{})
+                    , storage(MoveTemp(storage_))
+                {
+                }
+
+            protected:
+                FORCEINLINE_DEBUGGABLE Value GetValue() const
+                {
+                    check(*this);
+                    return GetValue(::Types::MakeIndexSequence<dimensions>{});
+                }
+
+                FORCEINLINE_DEBUGGABLE bool Equals(const ConstIterator& other) const
+                {
+                    return Base::GetValue().code == static_cast<const Base&>(other).GetValue().code;
+                }
+
+                FORCEINLINE_DEBUGGABLE ::Types::Optional<Position> ShiftForward()
+                {
+                    auto v = Base::GetValue();
+                    if (!storage->order.Advance(storage->extents, v))
+                        return {};
+                    return v;
+                }
+
+                TSharedPtr<const Storage> storage;
+
+            private:
+                template <std::size_t... indices>
+                FORCEINLINE_DEBUGGABLE Value GetValue(::Types::IndexSequence<indices...>) const
+                {
+                    const auto& position = Base::GetValue();
+                    return MakeTuple(storage->values.template Get<indices>()[position.coordinates[indices]]...);
+                }
+            };
+
+            FORCEINLINE_DEBUGGABLE Ordered(const TTuple<TRanges...>& ranges, Order order) : storage(MakeShared<Storage>(ranges, MoveTemp(order))) {}
+            FORCEINLINE_DEBUGGABLE ConstIterator begin() const { return { IteratorCtorLocker{}, storage, }; }
+            FORCEINLINE_DEBUGGABLE ConstIterator end() const { return {}; }
+
+            FORCEINLINE_DEBUGGABLE int32 Num() const
+            {
+                auto ret = 1;
+                for (auto extent : storage->extents)
+                    ret *= FMath::Max(extent, 0);
+                return ret;
+            }
+
+        private:
+            TSharedPtr<const Storage> storage;
+        };
+    }
+
+    template <class... TRanges>
+    auto Tiled(const Types::Join<TRanges...>& join, int32 tileSize) { return Types::Ordered<Order::Tiled, TRanges...>{ join.GetRanges(), Order::Tiled<sizeof...(TRanges)>{ tileSize }, }; }
+
+    template <class... TRanges>
+    auto Morton(const Types::Join<TRanges...>& join) { return Types::Ordered<Order::Morton, TRanges...>{ join.GetRanges(), {}, }; }
+
+    template <class... TRanges>
+    auto Hilbert(const Types::Join<TRanges...>& join) { return Types::Ordered<Order::Hilbert, TRanges...>{ join.GetRanges(), {}, }; }
+
+    template <template <std::size_t> class TOrder, class... TRanges>
+    constexpr bool IsRange<Types::Ordered<TOrder, TRanges...>> = true;
+}
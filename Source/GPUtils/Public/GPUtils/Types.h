@@ -4,6 +4,13 @@
 #include <Templates/EnableIf.h>
 #include <Templates/IsPointer.h>
 
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// check() that is skipped during constant evaluation, so code using it stays usable in constexpr context.
+#define GPUTILS_CHECK(expr) do { if (!std::is_constant_evaluated()) [&]() { check(expr); }(); } while (false)
+
 namespace Types
 {
     template <bool condition, class TType>
@@ -74,4 +81,96 @@ namespace Types
 
     template <class TFrom, class TTo>
     constexpr bool CanBeCastTo<TFrom, TTo, Void<decltype(static_cast<TTo>(DeclVal<TFrom>()))>> = true;
-}
+
+    template <class TType, class = Void<>>
+    constexpr bool HasNum = false;
+
+    template <class TType>
+    constexpr bool HasNum<TType, Void<decltype(DeclVal<const TType&>().Num())>> = true;
+
+    // Minimal constexpr replacement for TOptional. Assignment rebuilds the value, so types without copy assignment (like lambdas) can be stored too.
+    template <class TValue>
+    struct Optional
+    {
+    public:
+        constexpr Optional() : empty{}, set(false) {}
+        constexpr Optional(const TValue& value_) : value(value_), set(true) {}
+        constexpr Optional(TValue&& value_) : value(std::move(value_)), set(true) {}
+
+        constexpr Optional(const Optional& other) : empty{}, set(false)
+        {
+            if (other.set)
+                Emplace(other.value);
+        }
+
+        constexpr Optional(Optional&& other) : empty{}, set(false)
+        {
+            if (other.set)
+                Emplace(std::move(other.value));
+        }
+
+        constexpr ~Optional() { Reset(); }
+
+        constexpr Optional& operator=(const Optional& other)
+        {
+            if (this != &other)
+            {
+                Reset();
+                if (other.set)
+                    Emplace(other.value);
+            }
+            return *this;
+        }
+
+        constexpr Optional& operator=(Optional&& other)
+        {
+            if (this != &other)
+            {
+                Reset();
+                if (other.set)
+                    Emplace(std::move(other.value));
+            }
+            return *this;
+        }
+
+        constexpr bool IsSet() const { return set; }
+        constexpr explicit operator bool() const { return set; }
+
+        constexpr const TValue& GetValue() const { GPUTILS_CHECK(set); return value; }
+        constexpr TValue& GetValue() { GPUTILS_CHECK(set); return value; }
+
+        constexpr const TValue& operator*() const { return GetValue(); }
+        constexpr TValue& operator*() { return GetValue(); }
+        constexpr const TValue* operator->() const { return &GetValue(); }
+        constexpr TValue* operator->() { return &GetValue(); }
+
+        constexpr TValue Get(const TValue& fallback) const { return set ? value : fallback; }
+
+        template <class... TArgs>
+        constexpr TValue& Emplace(TArgs&&... args)
+        {
+            Reset();
+            std::construct_at(&value, std::forward<TArgs>(args)...);
+            set = true;
+            return value;
+        }
+
+        constexpr void Reset()
+        {
+            if (!set)
+                return;
+            value.~TValue();
+            set = false;
+        }
+
+    private:
+        struct Empty {};
+
+        union
+        {
+            Empty empty;
+            TValue value;
+        };
+        bool set;
+    };
+}
\ No newline at end of file
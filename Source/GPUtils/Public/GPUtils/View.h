@@ -0,0 +1,179 @@
+#pragma once
+
+#include <GPUtils/Collect.h>
+#include <GPUtils/Iterators.h>
+#include <GPUtils/Range.h>
+#include <GPUtils/Simd.h>
+
+#include <CoreMinimal.h>
+#include <Templates/IsTriviallyCopyConstructible.h>
+
+namespace Range
+{
+    namespace Types
+    {
+        // Non-owning range over a contiguous block of elements (TArray, TArrayView, raw pointers). Iterates pointers, so there are no bounds checks per element.
+        template <class TElement>
+        struct View
+        {
+        private:
+            struct IteratorCtorLocker {};
+
+        public:
+            using Value = TElement;
+
+            struct ConstIterator : Iterators::ConstBidirBase<const TElement*, ConstIterator>
+            {
+            private:
+                using Base = Iterators::ConstBidirBase<const TElement*, ConstIterator>;
+                friend Iterators::ConstBase<const TElement*, ConstIterator>;
+                friend Base;
+
+            public:
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator() = default;
+
+                FORCEINLINE_DEBUGGABLE constexpr ConstIterator(IteratorCtorLocker, const TElement* at, const TElement* first_, const TElement* last_)
+                    : Base((at != nullptr && at < last_) ? ::Types::Optional<const TElement*>{ at } : ::Types::Optional<const TElement*>{})
+                    , first(first_)
+                    , last(last_)
+                {
+                }
+
+            protected:
+                FORCEINLINE_DEBUGGABLE constexpr const TElement& GetValue() const
+                {
+                    GPUTILS_CHECK(*this);
+                    return *Base::GetValue();
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr bool Equals(const ConstIterator& other) const
+                {
+                    return Base::GetValue() == static_cast<const Base&>(other).GetValue();
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<const TElement*> ShiftForward(std::size_t count = 1)
+                {
+                    const auto v = Base::GetValue();
+                    if (static_cast<std::size_t>(last - v) <= count)
+                        return {};
+                    return v + count;
+                }
+
+                FORCEINLINE_DEBUGGABLE constexpr ::Types::Optional<const TElement*> ShiftBack()
+                {
+                    const auto v = Base::GetValue();
+                    if (v == first)
+                        return {};
+                    return v - 1;
+                }
+
+                const TElement* first = nullptr;
+                const TElement* last = nullptr;
+            };
+
+            FORCEINLINE_DEBUGGABLE constexpr View(const TElement* data_, int32 num_) : data(data_), num(FMath::Max(num_, 0)) {}
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator begin() const { return { IteratorCtorLocker{}, data, data, data + num, }; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator end() const { return {}; }
+            FORCEINLINE_DEBUGGABLE constexpr ConstIterator Last() const { return { IteratorCtorLocker{}, num > 0 ? data + num - 1 : nullptr, data, data + num, }; }
+
+            FORCEINLINE_DEBUGGABLE constexpr int32 Num() const { return num; }
+            FORCEINLINE_DEBUGGABLE constexpr const TElement* GetData() const { return data; }
+
+        private:
+            const TElement* data;
+            int32 num;
+        };
+    }
+
+    template <class TElement>
+    constexpr auto View(const TElement* data, int32 num) { return Types::View<TElement>{ data, num, }; }
+
+    template <class TContainer>
+    constexpr auto View(const TContainer& container) { return View(container.GetData(), container.Num()); }
+
+    template <class TElement>
+    constexpr bool IsRange<Types::View<TElement>> = true;
+
+    template <class TElement>
+    constexpr bool IsContiguous<Types::View<TElement>> = true;
+
+    // Copies the range into memory starting at `to`, which must have room for all of its elements. Contiguous trivially copyable sources are copied with one Memcpy.
+    template <class TRange, class TElement>
+    void Copy(const TRange& from, TElement* to)
+    {
+        if constexpr (IsContiguous<TRange> && ::Types::AreSame<ElementOf<TRange>, TElement> && TIsTriviallyCopyConstructible<TElement>::Value)
+        {
+            if (from.Num() > 0)
+                FMemory::Memcpy(to, from.GetData(), from.Num() * sizeof(TElement));
+        }
+        else
+        {
+            for (auto&& element : from)
+                *to++ = element;
+        }
+    }
+
+    template <class TContainer, class TElement>
+    void Fill(TContainer& to, const TElement& value)
+    {
+        auto* data = to.GetData();
+        const auto num = to.Num();
+        using TData = std::remove_cv_t<std::remove_reference_t<decltype(*data)>>;
+        if constexpr (sizeof(TData) == 1 && TIsTriviallyCopyConstructible<TData>::Value && std::is_constructible_v<TData, const TElement&>)
+        {
+            // Converted first and then reinterpreted, so 1-byte enums and structs take this path too.
+            const auto converted = static_cast<TData>(value);
+            auto byte = uint8{};
+            FMemory::Memcpy(&byte, &converted, 1);
+            FMemory::Memset(data, byte, num);
+        }
+        else
+        {
+            for (auto i = 0; i < num; ++i)
+                data[i] = value;
+        }
+    }
+
+    // Writes functor(element) for every element of the view to `to`. Simd::Packed functors are applied a whole register at a time, the remainder
+    // as one padded register like Range::Batch's last one, of which only the valid lanes are stored.
+    template <class TElement, class TTo, class TFunctor>
+    void Transform(const Types::View<TElement>& from, TTo* to, const TFunctor& functor)
+    {
+        const auto* data = from.GetData();
+        const auto num = from.Num();
+        auto i = 0;
+
+        if constexpr (Simd::IsPacked<TFunctor>)
+        {
+            using Lanes = Simd::Lanes<TElement>;
+            static_assert(::Types::AreSame<decltype(functor.functor(DeclVal<const Lanes&>())), Simd::Lanes<TTo>>, "Packed functors must return lanes of the destination type.");
+
+            for (; i + Lanes::width <= num; i += Lanes::width)
+            {
+                auto lanes = Lanes{};
+                for (auto lane = 0; lane < Lanes::width; ++lane)
+                    lanes.values[lane] = data[i + lane];
+                const auto result = functor.functor(lanes);
+                for (auto lane = 0; lane < Lanes::width; ++lane)
+                    to[i + lane] = result.values[lane];
+            }
+
+            if (i < num)
+            {
+                auto lanes = Lanes{};
+                lanes.count = num - i;
+                for (auto lane = 0; lane < lanes.count; ++lane)
+                    lanes.values[lane] = data[i + lane];
+                lanes.Pad();
+                const auto result = Simd::Apply(functor, lanes);
+                for (auto lane = 0; lane < result.count; ++lane)
+                    to[i + lane] = result.values[lane];
+            }
+        }
+        else
+        {
+            for (; i < num; ++i)
+                to[i] = functor(data[i]);
+        }
+    }
+}